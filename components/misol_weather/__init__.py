@@ -1,23 +1,312 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import uart
+from esphome import automation
+from esphome.components import time, uart, web_server_base
+from esphome.core import CORE
 from esphome.const import (
+    CONF_ADDRESS,
+    CONF_FORMAT,
+    CONF_HUMIDITY,
     CONF_ID,
+    CONF_LIGHT,
+    CONF_PATH,
+    CONF_PORT,
+    CONF_PRESSURE,
+    CONF_QOS,
+    CONF_RETAIN,
+    CONF_TEMPERATURE,
+    CONF_THRESHOLD,
+    CONF_TIME_ID,
+    CONF_TOPIC,
+    CONF_TRIGGER_ID,
+    CONF_WEB_SERVER_BASE_ID,
+    CONF_WIND_SPEED,
+    CONF_WINDOW_SIZE,
 )
 
 CODEOWNERS = ["@paveldn"]
 DEPENDENCIES = ["uart"]
 
+CONF_COMMUNICATION_TIMEOUT = "communication_timeout"
+CONF_DIRECTION = "direction"
+CONF_ENTITY_STATES = "entity_states"
+CONF_FIELDS = "fields"
+CONF_FLIGHT_RECORDER_SIZE = "flight_recorder_size"
+CONF_HISTORY = "history"
+CONF_INFLUXDB = "influxdb"
+CONF_INGESTION_MODE = "ingestion_mode"
+CONF_LOWER = "lower"
+CONF_MEASUREMENT = "measurement"
+CONF_METHOD = "method"
+CONF_METRICS = "metrics"
 CONF_MISOL_ID = "misol_id"
+CONF_MQTT_FRAME = "mqtt_frame"
+CONF_ON_FRAME = "on_frame"
+CONF_ON_GUST_ABOVE = "on_gust_above"
+CONF_ON_RAIN_START = "on_rain_start"
+CONF_ON_RAIN_STOP = "on_rain_stop"
+CONF_ON_TEMPERATURE_CROSS = "on_temperature_cross"
+CONF_OUTLIER_FILTER = "outlier_filter"
+CONF_PROFILING = "profiling"
+CONF_RAIN_DRY_TIME = "rain_dry_time"
+CONF_RESET = "reset"
+CONF_TAGS = "tags"
+CONF_TIMEOUT_PERIODS = "timeout_periods"
+CONF_UPPER = "upper"
+CONF_UV_INTENSITY = "uv_intensity"
+CONF_WIND_GUST = "wind_gust"
 
 misol_ns = cg.esphome_ns.namespace("misol_weather")
 WeatherStation = misol_ns.class_("WeatherStation", uart.UARTDevice, cg.Component)
+DumpFramesAction = misol_ns.class_("DumpFramesAction", automation.Action)
+DumpProfileAction = misol_ns.class_("DumpProfileAction", automation.Action)
+DecodedFrame = misol_ns.struct("DecodedFrame")
+DecodedFrameConstRef = DecodedFrame.operator("ref").operator("const")
+FrameTrigger = misol_ns.class_("FrameTrigger", automation.Trigger.template(DecodedFrameConstRef))
+RainStartTrigger = misol_ns.class_("RainStartTrigger", automation.Trigger.template())
+RainStopTrigger = misol_ns.class_("RainStopTrigger", automation.Trigger.template())
+GustAboveTrigger = misol_ns.class_("GustAboveTrigger", automation.Trigger.template(cg.float_))
+TemperatureCrossTrigger = misol_ns.class_(
+    "TemperatureCrossTrigger", automation.Trigger.template(cg.float_, cg.bool_)
+)
+Field = misol_ns.enum("Field")
+OutlierFilterMethod = misol_ns.enum("OutlierFilterMethod", is_class=True)
+FrameFormat = misol_ns.enum("FrameFormat", is_class=True)
+MetricsHandler = misol_ns.class_("MetricsHandler", cg.Component)
+HistoryHandler = misol_ns.class_("HistoryHandler", cg.Component)
+
+INGESTION_MODE_DMA = "dma"
+INGESTION_MODE_POLLING = "polling"
+INGESTION_MODE_TASK = "task"
+INGESTION_MODE_UART_EVENT = "uart_event"
+INGESTION_MODES = [
+    INGESTION_MODE_DMA,
+    INGESTION_MODE_POLLING,
+    INGESTION_MODE_TASK,
+    INGESTION_MODE_UART_EVENT,
+]
+
+DIRECTION_ANY = "any"
+DIRECTION_FALLING = "falling"
+DIRECTION_RISING = "rising"
+DIRECTIONS = [DIRECTION_ANY, DIRECTION_FALLING, DIRECTION_RISING]
+
+FRAME_FORMATS = {
+    "cbor": FrameFormat.CBOR,
+    "json": FrameFormat.JSON,
+}
+
+OUTLIER_FILTER_METHODS = {
+    "hampel": OutlierFilterMethod.HAMPEL,
+    "median": OutlierFilterMethod.MEDIAN,
+}
+
+FILTERED_FIELDS = {
+    CONF_TEMPERATURE: Field.FIELD_TEMPERATURE,
+    CONF_HUMIDITY: Field.FIELD_HUMIDITY,
+    CONF_WIND_SPEED: Field.FIELD_WIND_SPEED,
+    CONF_WIND_GUST: Field.FIELD_WIND_GUST,
+    CONF_UV_INTENSITY: Field.FIELD_UV_INTENSITY,
+    CONF_LIGHT: Field.FIELD_LIGHT,
+    CONF_PRESSURE: Field.FIELD_PRESSURE,
+}
+
+
+def validate_odd(value):
+    if value % 2 == 0:
+        raise cv.Invalid("Window size must be odd")
+    return value
+
+
+def validate_ingestion_mode(value):
+    value = cv.one_of(*INGESTION_MODES, lower=True)(value)
+    if value == INGESTION_MODE_UART_EVENT and not CORE.using_esp_idf:
+        raise cv.Invalid("uart_event ingestion mode requires the esp-idf framework")
+    if value == INGESTION_MODE_TASK and not CORE.is_esp32:
+        raise cv.Invalid("task ingestion mode is only available on ESP32")
+    if value == INGESTION_MODE_DMA and not CORE.is_rp2040:
+        raise cv.Invalid("dma ingestion mode is only available on RP2040")
+    return value
+
+
+def validate_threshold_band(value):
+    if isinstance(value, dict) and value[CONF_LOWER] > value[CONF_UPPER]:
+        raise cv.Invalid("Lower threshold must not be above the upper threshold")
+    return value
+
 
-CONFIG_SCHEMA = cv.Schema(
+# Single threshold or a hysteresis band, see threshold_band()
+THRESHOLD_SCHEMA = cv.All(
+    cv.Any(
+        cv.float_,
+        cv.Schema(
+            {
+                cv.Required(CONF_UPPER): cv.float_,
+                cv.Required(CONF_LOWER): cv.float_,
+            }
+        ),
+    ),
+    validate_threshold_band,
+)
+
+
+def threshold_band(threshold):
+    """Returns (lower, upper) of a validated THRESHOLD_SCHEMA value."""
+    if isinstance(threshold, float):
+        return threshold, threshold
+    return threshold[CONF_LOWER], threshold[CONF_UPPER]
+
+
+OUTLIER_FILTER_SCHEMA = cv.Schema(
     {
-        cv.GenerateID(): cv.declare_id(WeatherStation),
+        cv.Optional(CONF_METHOD, default="hampel"): cv.enum(OUTLIER_FILTER_METHODS, lower=True),
+        cv.Optional(CONF_WINDOW_SIZE, default=5): cv.All(cv.int_range(min=3, max=15), validate_odd),
+        cv.Optional(CONF_THRESHOLD, default=3.0): cv.positive_float,
+        cv.Optional(CONF_FIELDS, default=list(FILTERED_FIELDS)): cv.ensure_list(
+            cv.enum(FILTERED_FIELDS, lower=True)
+        ),
     }
-).extend(uart.UART_DEVICE_SCHEMA)
+)
+
+def validate_entity_states(config):
+    if not config[CONF_ENTITY_STATES] and config[CONF_FORMAT] != "json":
+        raise cv.Invalid(
+            f"Without {CONF_ENTITY_STATES} Home Assistant reads the sensor states from the frame message, "
+            f"which requires the json {CONF_FORMAT}"
+        )
+    return config
+
+
+MQTT_FRAME_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_TOPIC): cv.publish_topic,
+            cv.Optional(CONF_FORMAT, default="json"): cv.enum(FRAME_FORMATS, lower=True),
+            cv.Optional(CONF_QOS, default=0): cv.mqtt_qos,
+            cv.Optional(CONF_RETAIN, default=False): cv.boolean,
+            cv.Optional(CONF_ENTITY_STATES, default=True): cv.boolean,
+        }
+    ),
+    validate_entity_states,
+    cv.requires_component("mqtt"),
+)
+
+def escape_line_protocol(value, special):
+    for char in "\\" + special:
+        value = value.replace(char, "\\" + char)
+    return value
+
+
+# MAX_FRAME_MESSAGE_SIZE of frame_serializer.h, the buffer of the line protocol message
+MAX_FRAME_MESSAGE_SIZE = 512
+# Longest field set, time stamp and line feed written after the prefix
+LINE_PROTOCOL_MAX_FIELDS_SIZE = 281
+
+
+def line_protocol_prefix(config):
+    """Measurement and tag set of the line protocol, tags sorted by key as recommended by InfluxDB."""
+    prefix = escape_line_protocol(config[CONF_MEASUREMENT], ", ")
+    for key, value in sorted(config[CONF_TAGS].items()):
+        prefix += f",{escape_line_protocol(key, ',= ')}={escape_line_protocol(value, ',= ')}"
+    return prefix
+
+
+def validate_line_protocol_prefix(config):
+    max_length = MAX_FRAME_MESSAGE_SIZE - LINE_PROTOCOL_MAX_FIELDS_SIZE
+    length = len(line_protocol_prefix(config).encode("utf-8"))
+    if length > max_length:
+        raise cv.Invalid(
+            f"The {CONF_MEASUREMENT} and {CONF_TAGS} take {length} bytes in the line protocol, at most "
+            f"{max_length} fit in the message"
+        )
+    return config
+
+
+NON_EMPTY_STRING = cv.All(cv.string_strict, cv.Length(min=1))
+
+INFLUXDB_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Required(CONF_ADDRESS): cv.ipv4address,
+            cv.Optional(CONF_PORT, default=8089): cv.port,
+            cv.Optional(CONF_MEASUREMENT, default="weather"): NON_EMPTY_STRING,
+            cv.Optional(CONF_TAGS, default={}): cv.Schema({NON_EMPTY_STRING: NON_EMPTY_STRING}),
+        }
+    ),
+    validate_line_protocol_prefix,
+)
+
+METRICS_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(MetricsHandler),
+        cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+        cv.Optional(CONF_PATH, default="/metrics"): cv.string_strict,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+HISTORY_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(HistoryHandler),
+        cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+        cv.Optional(CONF_PATH, default="/history"): cv.string_strict,
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def validate_history(config):
+    if CONF_HISTORY in config and CONF_FLIGHT_RECORDER_SIZE not in config:
+        raise cv.Invalid(f"{CONF_HISTORY} serves the flight recorder, set {CONF_FLIGHT_RECORDER_SIZE}")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(WeatherStation),
+            cv.Optional(CONF_PROFILING, default=False): cv.boolean,
+            cv.Optional(CONF_INGESTION_MODE, default=INGESTION_MODE_POLLING): validate_ingestion_mode,
+            cv.Optional(CONF_FLIGHT_RECORDER_SIZE): cv.int_range(min=1, max=255),
+            cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+            cv.Optional(CONF_OUTLIER_FILTER): OUTLIER_FILTER_SCHEMA,
+            cv.Optional(CONF_MQTT_FRAME): MQTT_FRAME_SCHEMA,
+            cv.Optional(CONF_INFLUXDB): INFLUXDB_SCHEMA,
+            cv.Optional(CONF_METRICS): METRICS_SCHEMA,
+            cv.Optional(CONF_HISTORY): HISTORY_SCHEMA,
+            cv.Exclusive(CONF_COMMUNICATION_TIMEOUT, "timeout"): cv.positive_time_period_milliseconds,
+            cv.Exclusive(CONF_TIMEOUT_PERIODS, "timeout"): cv.int_range(min=2, max=100),
+            cv.Optional(CONF_RAIN_DRY_TIME, default="30min"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_ON_FRAME): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(FrameTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_RAIN_START): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(RainStartTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_RAIN_STOP): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(RainStopTrigger),
+                }
+            ),
+            cv.Optional(CONF_ON_GUST_ABOVE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(GustAboveTrigger),
+                    cv.Required(CONF_THRESHOLD): THRESHOLD_SCHEMA,
+                }
+            ),
+            cv.Optional(CONF_ON_TEMPERATURE_CROSS): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(TemperatureCrossTrigger),
+                    cv.Required(CONF_THRESHOLD): THRESHOLD_SCHEMA,
+                    cv.Optional(CONF_DIRECTION, default=DIRECTION_ANY): cv.one_of(*DIRECTIONS, lower=True),
+                }
+            ),
+        }
+    ).extend(uart.UART_DEVICE_SCHEMA),
+    validate_history,
+)
 
 
 FINAL_VALIDATE_SCHEMA = uart.final_validate_device_schema(
@@ -35,3 +324,119 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     await uart.register_uart_device(var, config)
+    if CONF_COMMUNICATION_TIMEOUT in config:
+        cg.add(var.set_communication_timeout(config[CONF_COMMUNICATION_TIMEOUT]))
+    if CONF_TIMEOUT_PERIODS in config:
+        cg.add(var.set_timeout_periods(config[CONF_TIMEOUT_PERIODS]))
+    cg.add(var.set_rain_dry_time(config[CONF_RAIN_DRY_TIME]))
+    if CONF_FLIGHT_RECORDER_SIZE in config:
+        cg.add(var.set_flight_recorder_size(config[CONF_FLIGHT_RECORDER_SIZE]))
+    if CONF_TIME_ID in config:
+        time_ = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time(time_))
+    if mqtt_frame := config.get(CONF_MQTT_FRAME):
+        cg.add_define("USE_MISOL_WEATHER_MQTT_FRAME")
+        cg.add(
+            var.set_mqtt_frame(
+                mqtt_frame.get(CONF_TOPIC, ""),
+                mqtt_frame[CONF_FORMAT],
+                mqtt_frame[CONF_QOS],
+                mqtt_frame[CONF_RETAIN],
+                mqtt_frame[CONF_ENTITY_STATES],
+            )
+        )
+    if influxdb := config.get(CONF_INFLUXDB):
+        cg.add_define("USE_MISOL_WEATHER_INFLUXDB")
+        cg.add(
+            var.set_influxdb(
+                str(influxdb[CONF_ADDRESS]),
+                influxdb[CONF_PORT],
+                line_protocol_prefix(influxdb),
+            )
+        )
+    if metrics := config.get(CONF_METRICS):
+        cg.add_define("USE_MISOL_WEATHER_METRICS")
+        base = await cg.get_variable(metrics[CONF_WEB_SERVER_BASE_ID])
+        handler = cg.new_Pvariable(metrics[CONF_ID], base, var, metrics[CONF_PATH])
+        await cg.register_component(handler, metrics)
+    if history := config.get(CONF_HISTORY):
+        cg.add_define("USE_MISOL_WEATHER_HISTORY")
+        base = await cg.get_variable(history[CONF_WEB_SERVER_BASE_ID])
+        handler = cg.new_Pvariable(history[CONF_ID], base, var, history[CONF_PATH])
+        await cg.register_component(handler, history)
+    if outlier_filter := config.get(CONF_OUTLIER_FILTER):
+        cg.add(
+            var.set_outlier_filter(
+                outlier_filter[CONF_METHOD],
+                outlier_filter[CONF_WINDOW_SIZE],
+                outlier_filter[CONF_THRESHOLD],
+            )
+        )
+        for field in outlier_filter[CONF_FIELDS]:
+            cg.add(var.enable_outlier_filter_field(field))
+    for conf in config.get(CONF_ON_FRAME, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(DecodedFrameConstRef, "frame")], conf)
+    for conf in config.get(CONF_ON_RAIN_START, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [], conf)
+    for conf in config.get(CONF_ON_RAIN_STOP, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [], conf)
+    for conf in config.get(CONF_ON_GUST_ABOVE, []):
+        lower, upper = threshold_band(conf[CONF_THRESHOLD])
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var, lower, upper)
+        await automation.build_automation(trigger, [(cg.float_, "x")], conf)
+    for conf in config.get(CONF_ON_TEMPERATURE_CROSS, []):
+        lower, upper = threshold_band(conf[CONF_THRESHOLD])
+        direction = conf[CONF_DIRECTION]
+        trigger = cg.new_Pvariable(
+            conf[CONF_TRIGGER_ID],
+            var,
+            lower,
+            upper,
+            direction != DIRECTION_FALLING,
+            direction != DIRECTION_RISING,
+        )
+        await automation.build_automation(trigger, [(cg.float_, "x"), (cg.bool_, "rising")], conf)
+    if config[CONF_PROFILING]:
+        cg.add_define("USE_MISOL_WEATHER_PROFILING")
+    if config[CONF_INGESTION_MODE] == INGESTION_MODE_UART_EVENT:
+        cg.add_define("USE_MISOL_WEATHER_UART_EVENT")
+    if config[CONF_INGESTION_MODE] == INGESTION_MODE_TASK:
+        cg.add_define("USE_MISOL_WEATHER_TASK")
+    if config[CONF_INGESTION_MODE] == INGESTION_MODE_DMA:
+        cg.add_define("USE_MISOL_WEATHER_DMA")
+
+
+@automation.register_action(
+    "misol_weather.dump_frames",
+    DumpFramesAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(WeatherStation),
+        }
+    ),
+)
+async def dump_frames_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "misol_weather.dump_profile",
+    DumpProfileAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(WeatherStation),
+            cv.Optional(CONF_RESET, default=False): cv.templatable(cv.boolean),
+        }
+    ),
+)
+async def dump_profile_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    template_ = await cg.templatable(config[CONF_RESET], args, bool)
+    cg.add(var.set_reset(template_))
+    return var
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "edge_detector.h"
+#include "weather_station.h"
+
+namespace esphome {
+namespace misol_weather {
+
+template<typename... Ts> class DumpFramesAction : public Action<Ts...>, public Parented<WeatherStation> {
+ public:
+  void play(Ts... x) override { this->parent_->dump_frames(); }
+};
+
+template<typename... Ts> class DumpProfileAction : public Action<Ts...>, public Parented<WeatherStation> {
+ public:
+  TEMPLATABLE_VALUE(bool, reset)
+
+  void play(Ts... x) override { this->parent_->dump_profile(this->reset_.value(x...)); }
+};
+
+class FrameTrigger : public Trigger<const DecodedFrame &> {
+ public:
+  explicit FrameTrigger(WeatherStation *parent) {
+    parent->add_on_frame_callback([this](const DecodedFrame &frame, uint32_t timestamp_ms) { this->trigger(frame); });
+  }
+};
+
+class RainStartTrigger : public Trigger<> {
+ public:
+  explicit RainStartTrigger(WeatherStation *parent) {
+    parent->add_on_rain_callback([this](bool raining) {
+      if (raining)
+        this->trigger();
+    });
+  }
+};
+
+class RainStopTrigger : public Trigger<> {
+ public:
+  explicit RainStopTrigger(WeatherStation *parent) {
+    parent->add_on_rain_callback([this](bool raining) {
+      if (!raining)
+        this->trigger();
+    });
+  }
+};
+
+class GustAboveTrigger : public Trigger<float> {
+ public:
+  GustAboveTrigger(WeatherStation *parent, float lower_threshold, float upper_threshold)
+      : detector_(lower_threshold, upper_threshold) {
+    parent->add_on_frame_callback([this](const DecodedFrame &frame, uint32_t timestamp_ms) {
+      float wind_gust = frame.get_wind_gust();
+      if (this->detector_.update(wind_gust) == Edge::RISING)
+        this->trigger(wind_gust);
+    });
+  }
+
+ protected:
+  CrossingDetector detector_;
+};
+
+class TemperatureCrossTrigger : public Trigger<float, bool> {
+ public:
+  TemperatureCrossTrigger(WeatherStation *parent, float lower_threshold, float upper_threshold, bool rising,
+                          bool falling)
+      : detector_(lower_threshold, upper_threshold) {
+    parent->add_on_frame_callback([this, rising, falling](const DecodedFrame &frame, uint32_t timestamp_ms) {
+      float temperature = frame.get_temperature();
+      Edge edge = this->detector_.update(temperature);
+      if (((edge == Edge::RISING) && rising) || ((edge == Edge::FALLING) && falling))
+        this->trigger(temperature, edge == Edge::RISING);
+    });
+  }
+
+ protected:
+  CrossingDetector detector_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,88 @@
+#include "battery_monitor.h"
+#include <cmath>
+
+namespace esphome {
+namespace misol_weather {
+
+static const uint32_t HOUR_MS = 60 * 60 * 1000;
+// Weight of older hourly ratios in the trend, halves in about 3 days
+static const double TREND_DECAY = 0.99;
+
+void BatteryMonitor::update(bool low_battery, uint32_t timestamp_ms) {
+  if (!this->has_state_) {
+    this->has_state_ = true;
+    this->state_ = low_battery;
+    this->pending_ = low_battery;
+    this->pending_since_ms_ = timestamp_ms;
+  } else {
+    // Unsigned difference, survives the wrap of the millisecond counter
+    uint32_t elapsed = timestamp_ms - this->last_timestamp_ms_;
+    this->hour_elapsed_ms_ += elapsed;
+    while (this->hour_elapsed_ms_ >= HOUR_MS) {
+      this->hour_elapsed_ms_ -= HOUR_MS;
+      this->close_hour_();
+    }
+    if (low_battery != this->pending_) {
+      this->pending_ = low_battery;
+      this->pending_since_ms_ = timestamp_ms;
+    }
+    if ((this->pending_ != this->state_) && (timestamp_ms - this->pending_since_ms_ >= this->dwell_time_ms_))
+      this->state_ = this->pending_;
+  }
+  this->last_timestamp_ms_ = timestamp_ms;
+  if (this->frames_[this->hour_index_] < UINT16_MAX) {
+    this->frames_[this->hour_index_]++;
+    if (low_battery)
+      this->low_frames_[this->hour_index_]++;
+  }
+}
+
+void BatteryMonitor::close_hour_() {
+  uint16_t frames = this->frames_[this->hour_index_];
+  if (frames > 0) {
+    double x = this->hours_;
+    double y = (double) this->low_frames_[this->hour_index_] / frames;
+    this->sum_weight_ = this->sum_weight_ * TREND_DECAY + 1.0;
+    this->sum_x_ = this->sum_x_ * TREND_DECAY + x;
+    this->sum_y_ = this->sum_y_ * TREND_DECAY + y;
+    this->sum_xx_ = this->sum_xx_ * TREND_DECAY + x * x;
+    this->sum_xy_ = this->sum_xy_ * TREND_DECAY + x * y;
+    if (this->trend_points_ < UINT16_MAX)
+      this->trend_points_++;
+  }
+  this->hours_++;
+  this->hour_index_ = (this->hour_index_ + 1) % HOURS_PER_DAY;
+  this->frames_[this->hour_index_] = 0;
+  this->low_frames_[this->hour_index_] = 0;
+}
+
+float BatteryMonitor::get_low_ratio() const {
+  uint32_t frames = 0;
+  uint32_t low_frames = 0;
+  for (uint8_t i = 0; i < HOURS_PER_DAY; i++) {
+    frames += this->frames_[i];
+    low_frames += this->low_frames_[i];
+  }
+  if (frames == 0)
+    return NAN;
+  return 100.0f * low_frames / frames;
+}
+
+float BatteryMonitor::get_days_to_failure() const {
+  if (this->trend_points_ < MIN_TREND_HOURS)
+    return NAN;
+  double denominator = this->sum_weight_ * this->sum_xx_ - this->sum_x_ * this->sum_x_;
+  if (denominator <= 0)
+    return NAN;
+  double slope = (this->sum_weight_ * this->sum_xy_ - this->sum_x_ * this->sum_y_) / denominator;
+  if (slope <= 0)
+    return NAN;
+  double intercept = (this->sum_y_ - slope * this->sum_x_) / this->sum_weight_;
+  double current = intercept + slope * this->hours_;
+  if (current >= 1.0)
+    return 0.0f;
+  return (1.0 - current) / slope / HOURS_PER_DAY;
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
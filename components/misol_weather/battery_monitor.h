@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Debounces the low battery flag of the station and tracks how often it is set. The share of frames
+// with the flag set grows as the battery (or the supercapacitor) ages, its trend is extrapolated to
+// the point where every frame reports a low battery.
+class BatteryMonitor {
+ public:
+  static const uint8_t HOURS_PER_DAY = 24;
+  // Hourly ratios needed before the trend is trusted
+  static const uint8_t MIN_TREND_HOURS = 6;
+
+  void set_dwell_time(uint32_t dwell_time_ms) { this->dwell_time_ms_ = dwell_time_ms; }
+  void update(bool low_battery, uint32_t timestamp_ms);
+  bool has_state() const { return this->has_state_; }
+  // Raw flag has to stay the same for the dwell time before the state changes
+  bool is_low() const { return this->state_; }
+  // Percentage of frames with the low battery flag over the last 24 hours, NAN without frames
+  float get_low_ratio() const;
+  // Days until every frame reports a low battery at the current trend, NAN while the trend is not rising
+  float get_days_to_failure() const;
+
+ protected:
+  void close_hour_();
+
+  uint32_t dwell_time_ms_{0};
+  bool has_state_{false};
+  bool state_{false};
+  bool pending_{false};
+  uint32_t pending_since_ms_{0};
+  uint32_t last_timestamp_ms_{0};
+  // Hourly buckets of the last day, the current hour is at hour_index_
+  uint16_t low_frames_[HOURS_PER_DAY]{};
+  uint16_t frames_[HOURS_PER_DAY]{};
+  uint8_t hour_index_{0};
+  uint32_t hour_elapsed_ms_{0};
+  uint32_t hours_{0};
+  // Exponentially weighted least squares of the hourly ratio (0..1) over the hour number
+  uint16_t trend_points_{0};
+  double sum_weight_{0};
+  double sum_x_{0};
+  double sum_y_{0};
+  double sum_xx_{0};
+  double sum_xy_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
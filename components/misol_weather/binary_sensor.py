@@ -3,22 +3,55 @@ import esphome.config_validation as cv
 from esphome.components import binary_sensor
 from esphome.const import (
     CONF_BATTERY_LEVEL,
+    CONF_MAX,
+    CONF_MIN,
     CONF_THRESHOLD,
     DEVICE_CLASS_BATTERY,
+    DEVICE_CLASS_PROBLEM,
     ENTITY_CATEGORY_DIAGNOSTIC,
 )
 from . import (
+    CONF_LOWER,
     CONF_MISOL_ID,
+    CONF_UPPER,
+    THRESHOLD_SCHEMA,
+    Field,
     WeatherStation,
+    threshold_band,
 )
 
 CODEOWNERS = ["@paveldn"]
 
+CONF_DWELL_TIME = "dwell_time"
+CONF_FLAT_LINE_DURATION = "flat_line_duration"
 CONF_NIGHT = "night"
-CONF_LOWER = "lower"
-CONF_UPPER = "upper"
 ICON_WEATHER_NIGHT = "mdi:weather-night"
 
+# Field, default plausible range
+FAULT_TYPES = {
+    "temperature_fault": (Field.FIELD_TEMPERATURE, -40.0, 60.0),
+    "humidity_fault": (Field.FIELD_HUMIDITY, 1.0, 99.0),
+    "wind_speed_fault": (Field.FIELD_WIND_SPEED, 0.0, 50.0),
+    "wind_direction_fault": (Field.FIELD_WIND_DIRECTION, 0.0, 359.0),
+    "uv_intensity_fault": (Field.FIELD_UV_INTENSITY, 0.0, 1000.0),
+    "light_fault": (Field.FIELD_LIGHT, 0.0, 200000.0),
+    "pressure_fault": (Field.FIELD_PRESSURE, 300.0, 1100.0),
+}
+
+
+def fault_schema(min_value, max_value):
+    return binary_sensor.binary_sensor_schema(
+        device_class=DEVICE_CLASS_PROBLEM,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ).extend(
+        {
+            cv.Optional(CONF_FLAT_LINE_DURATION, default="12h"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MIN, default=min_value): cv.float_,
+            cv.Optional(CONF_MAX, default=max_value): cv.float_,
+        }
+    )
+
+
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
@@ -26,6 +59,10 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_BATTERY_LEVEL): binary_sensor.binary_sensor_schema(
                 entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
                 device_class=DEVICE_CLASS_BATTERY,
+            ).extend(
+                {
+                    cv.Optional(CONF_DWELL_TIME, default="0s"): cv.positive_time_period_milliseconds,
+                }
             ),
             cv.Optional(CONF_NIGHT): binary_sensor.binary_sensor_schema(
                 icon=ICON_WEATHER_NIGHT,
@@ -37,18 +74,15 @@ CONFIG_SCHEMA = cv.All(
                             CONF_UPPER: 5.5,
                             CONF_LOWER: 4.5,
                         },
-                    ): cv.Any(
-                        cv.float_,
-                        cv.Schema(
-                            {
-                                cv.Required(CONF_UPPER): cv.float_,
-                                cv.Required(CONF_LOWER): cv.float_,
-                            }
-                        ),
-                    ),
+                    ): THRESHOLD_SCHEMA,
                 }
             ),
         }
+    ).extend(
+        {
+            cv.Optional(key): fault_schema(min_value, max_value)
+            for key, (_, min_value, max_value) in FAULT_TYPES.items()
+        }
     ),
 )
 
@@ -59,13 +93,23 @@ async def to_code(config):
     if conf := config.get(CONF_BATTERY_LEVEL):
         bat_sens = await binary_sensor.new_binary_sensor(conf)
         cg.add(paren.set_battery_level_binary_sensor(bat_sens))
+        cg.add(paren.set_battery_dwell_time(conf[CONF_DWELL_TIME]))
     if conf := config.get(CONF_NIGHT):
         night_sens = await binary_sensor.new_binary_sensor(conf)
         cg.add(paren.set_night_binary_sensor(night_sens))
         if threshold := conf.get(CONF_THRESHOLD):
-            if isinstance(threshold, float):
-                cg.add(paren.set_upper_night_threshold(threshold))
-                cg.add(paren.set_lower_night_threshold(threshold))
-            else:
-                cg.add(paren.set_upper_night_threshold(threshold[CONF_UPPER]))
-                cg.add(paren.set_lower_night_threshold(threshold[CONF_LOWER]))
+            lower, upper = threshold_band(threshold)
+            cg.add(paren.set_upper_night_threshold(upper))
+            cg.add(paren.set_lower_night_threshold(lower))
+    for key, (field, _, _) in FAULT_TYPES.items():
+        if conf := config.get(key):
+            fault_sens = await binary_sensor.new_binary_sensor(conf)
+            cg.add(
+                paren.set_fault_binary_sensor(
+                    field,
+                    fault_sens,
+                    conf[CONF_FLAT_LINE_DURATION],
+                    conf[CONF_MIN],
+                    conf[CONF_MAX],
+                )
+            )
@@ -0,0 +1,81 @@
+#include "cadence_tracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace misol_weather {
+
+// Do not trust the period estimate until this number of intervals was seen
+static const uint8_t MIN_INTERVALS_FOR_PERIOD = 5;
+
+void CadenceTracker::add_arrival(uint32_t timestamp_ms) {
+  if (!this->has_last_arrival_) {
+    this->has_last_arrival_ = true;
+    this->last_arrival_ms_ = timestamp_ms;
+    return;
+  }
+  uint32_t interval = timestamp_ms - this->last_arrival_ms_;
+  uint32_t slots = 1;
+  if (this->period_ms_ > 0) {
+    slots = (interval + this->period_ms_ / 2) / this->period_ms_;
+    if (slots == 0) {
+      // Extra frame within the same period (duplicate or split frame), not a new transmission
+      return;
+    }
+  }
+  this->last_arrival_ms_ = timestamp_ms;
+  this->intervals_[this->intervals_index_] = interval / slots;
+  this->intervals_index_ = (this->intervals_index_ + 1) % PERIOD_HISTORY_SIZE;
+  if (this->intervals_count_ < PERIOD_HISTORY_SIZE)
+    this->intervals_count_++;
+  if (this->period_ms_ == 0) {
+    if (this->intervals_count_ >= MIN_INTERVALS_FOR_PERIOD)
+      this->period_ms_ = this->estimate_period_();
+    return;
+  }
+  this->missed_total_ += slots - 1;
+  int32_t deviation = (int32_t) (interval - slots * this->period_ms_);
+  this->window_slots_[this->window_index_] = std::min<uint32_t>(slots, UINT8_MAX);
+  this->window_deviation_ms_[this->window_index_] = std::min<uint32_t>(std::abs(deviation), UINT16_MAX);
+  this->window_index_ = (this->window_index_ + 1) % WINDOW_SIZE;
+  if (this->window_count_ < WINDOW_SIZE)
+    this->window_count_++;
+  this->period_ms_ = this->estimate_period_();
+}
+
+float CadenceTracker::get_link_quality(uint32_t now_ms) const {
+  if (this->period_ms_ == 0)
+    return NAN;
+  uint32_t received = this->window_count_;
+  uint32_t expected = 0;
+  for (uint8_t i = 0; i < this->window_count_; i++)
+    expected += this->window_slots_[i];
+  if (this->has_last_arrival_) {
+    // Transmissions that are already overdue since the last arrival
+    uint32_t overdue = (now_ms - this->last_arrival_ms_) / this->period_ms_;
+    if (overdue > 1)
+      expected += overdue - 1;
+  }
+  if (expected == 0)
+    return NAN;
+  return received * 100.0f / expected;
+}
+
+float CadenceTracker::get_jitter_ms() const {
+  if (this->window_count_ == 0)
+    return NAN;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < this->window_count_; i++)
+    sum += this->window_deviation_ms_[i];
+  return (float) sum / this->window_count_;
+}
+
+uint32_t CadenceTracker::estimate_period_() const {
+  uint32_t sorted[PERIOD_HISTORY_SIZE];
+  std::copy(this->intervals_, this->intervals_ + this->intervals_count_, sorted);
+  std::nth_element(sorted, sorted + this->intervals_count_ / 2, sorted + this->intervals_count_);
+  return sorted[this->intervals_count_ / 2];
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
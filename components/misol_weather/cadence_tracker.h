@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Learns the nominal transmission period of the station from frame arrival times
+// and uses it to count transmissions that never arrived.
+class CadenceTracker {
+ public:
+  static const uint8_t PERIOD_HISTORY_SIZE = 15;
+  static const uint8_t WINDOW_SIZE = 32;
+
+  void add_arrival(uint32_t timestamp_ms);
+  // Nominal transmission period in milliseconds, 0 until learned
+  uint32_t get_period_ms() const { return this->period_ms_; }
+  uint32_t get_missed_transmissions() const { return this->missed_total_; }
+  // Percentage of expected transmissions received over the sliding window,
+  // including the transmissions overdue at the moment of the call. NAN until period is learned.
+  float get_link_quality(uint32_t now_ms) const;
+  // Mean absolute deviation of the arrival time from the expected one over the sliding window
+  float get_jitter_ms() const;
+
+ protected:
+  uint32_t estimate_period_() const;
+
+  bool has_last_arrival_{false};
+  uint32_t last_arrival_ms_{0};
+  uint32_t period_ms_{0};
+  uint32_t missed_total_{0};
+  // Inter-arrival intervals normalized to a single period
+  uint32_t intervals_[PERIOD_HISTORY_SIZE]{};
+  uint8_t intervals_count_{0};
+  uint8_t intervals_index_{0};
+  // Sliding window: how many periods each arrival took and its deviation from the expected time
+  uint8_t window_slots_[WINDOW_SIZE]{};
+  uint16_t window_deviation_ms_[WINDOW_SIZE]{};
+  uint8_t window_count_{0};
+  uint8_t window_index_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
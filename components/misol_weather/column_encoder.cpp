@@ -0,0 +1,182 @@
+#include "column_encoder.h"
+#include <cstring>
+
+namespace esphome {
+namespace misol_weather {
+
+static const uint8_t COLUMN_FILE_VERSION = 1;
+
+static const char *const RESULT_LABELS[] = {
+    frame_result_to_string(FrameResult::BASIC_PACKET),
+    frame_result_to_string(FrameResult::BASIC_WITH_PRESSURE),
+    frame_result_to_string(FrameResult::PRESSURE_CHECKSUM_FAILURE),
+    frame_result_to_string(FrameResult::CHECKSUM_FAILURE),
+    frame_result_to_string(FrameResult::TRUNCATED),
+};
+static const char *const COMPASS_LABELS[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+                                             "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
+
+static uint8_t column_type_size(ColumnType type) {
+  switch (type) {
+    case ColumnType::UINT16:
+      return 2;
+    case ColumnType::UINT32:
+    case ColumnType::INT32:
+      return 4;
+    case ColumnType::UINT64:
+      return 8;
+    default:
+      return 1;
+  }
+}
+
+uint8_t ColumnEncoder::add_column(const char *name, ColumnType type, bool nullable, double scale, double offset) {
+  Column &column = this->columns_[this->column_count_];
+  column.name = name;
+  column.type = type;
+  column.size = column_type_size(type);
+  column.nullable = nullable;
+  column.scale = scale;
+  column.offset = offset;
+  column.labels = nullptr;
+  column.label_count = 0;
+  return this->column_count_++;
+}
+
+uint8_t ColumnEncoder::add_dictionary_column(const char *name, const char *const *labels, uint8_t label_count,
+                                             bool nullable) {
+  uint8_t index = this->add_column(name, ColumnType::DICTIONARY, nullable);
+  this->columns_[index].labels = labels;
+  this->columns_[index].label_count = label_count;
+  return index;
+}
+
+void ColumnEncoder::set(uint8_t column_index, uint64_t value) {
+  if (!this->schema_written_)
+    this->write_schema_();
+  Column &column = this->columns_[column_index];
+  uint8_t *slot = column.values.get() + this->rows_ * column.size;
+  for (uint8_t i = 0; i < column.size; i++)
+    slot[i] = (uint8_t) (value >> (8 * i));
+  if (column.nullable)
+    column.validity[this->rows_ / 8] |= 1 << (this->rows_ % 8);
+}
+
+void ColumnEncoder::end_row() {
+  if (!this->schema_written_)
+    this->write_schema_();
+  if (++this->rows_ == this->rows_per_group_)
+    this->write_group_();
+}
+
+void ColumnEncoder::finish() {
+  if (!this->schema_written_)
+    this->write_schema_();
+  this->write_group_();
+  this->put_uint_(0, 4);
+}
+
+// Also allocates the row group, zeroed as unset values are 0
+void ColumnEncoder::write_schema_() {
+  this->sink_->write(reinterpret_cast<const uint8_t *>("MWCF"), 4);
+  this->put_uint_(COLUMN_FILE_VERSION, 1);
+  this->put_uint_(this->column_count_, 1);
+  for (uint8_t i = 0; i < this->column_count_; i++) {
+    Column &column = this->columns_[i];
+    size_t name_length = strlen(column.name);
+    this->put_uint_(name_length, 1);
+    this->sink_->write(reinterpret_cast<const uint8_t *>(column.name), name_length);
+    this->put_uint_((uint8_t) column.type, 1);
+    this->put_uint_(column.nullable, 1);
+    this->put_double_(column.scale);
+    this->put_double_(column.offset);
+    if (column.type == ColumnType::DICTIONARY) {
+      this->put_uint_(column.label_count, 1);
+      for (uint8_t label = 0; label < column.label_count; label++) {
+        size_t label_length = strlen(column.labels[label]);
+        this->put_uint_(label_length, 1);
+        this->sink_->write(reinterpret_cast<const uint8_t *>(column.labels[label]), label_length);
+      }
+    }
+    column.values.reset(new uint8_t[this->rows_per_group_ * column.size]());
+    if (column.nullable)
+      column.validity.reset(new uint8_t[(this->rows_per_group_ + 7) / 8]());
+  }
+  this->schema_written_ = true;
+}
+
+void ColumnEncoder::write_group_() {
+  if (this->rows_ == 0)
+    return;
+  this->put_uint_(this->rows_, 4);
+  size_t validity_size = (this->rows_ + 7) / 8;
+  for (uint8_t i = 0; i < this->column_count_; i++) {
+    Column &column = this->columns_[i];
+    if (column.nullable) {
+      this->sink_->write(column.validity.get(), validity_size);
+      memset(column.validity.get(), 0, validity_size);
+    }
+    this->sink_->write(column.values.get(), this->rows_ * column.size);
+    memset(column.values.get(), 0, this->rows_ * column.size);
+  }
+  this->rows_ = 0;
+}
+
+void ColumnEncoder::put_uint_(uint64_t value, uint8_t size) {
+  uint8_t bytes[8];
+  for (uint8_t i = 0; i < size; i++)
+    bytes[i] = (uint8_t) (value >> (8 * i));
+  this->sink_->write(bytes, size);
+}
+
+void ColumnEncoder::put_double_(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  this->put_uint_(bits, 8);
+}
+
+void FrameColumnSchema::add_to(ColumnEncoder &encoder) {
+  this->result = encoder.add_dictionary_column("result", RESULT_LABELS, 5, false);
+  this->wind_direction = encoder.add_column("wind_direction", ColumnType::UINT16, true);
+  this->compass_direction = encoder.add_dictionary_column("compass_direction", COMPASS_LABELS, 16, true);
+  this->low_battery = encoder.add_column("low_battery", ColumnType::UINT8, true);
+  this->temperature = encoder.add_column("temperature", ColumnType::UINT16, true, 0.1, -40.0);
+  this->humidity = encoder.add_column("humidity", ColumnType::UINT8, true);
+  this->wind_speed = encoder.add_column("wind_speed", ColumnType::UINT16, true, 0.14);
+  this->wind_gust = encoder.add_column("wind_gust", ColumnType::UINT8, true, 1.12);
+  this->precipitation = encoder.add_column("accumulated_precipitation", ColumnType::UINT16, true, 0.3);
+  this->uv_intensity = encoder.add_column("uv_intensity", ColumnType::UINT16, true, 0.1);
+  this->light = encoder.add_column("light", ColumnType::UINT32, true, 0.1);
+  this->pressure = encoder.add_column("pressure", ColumnType::UINT32, true, 0.01);
+  this->quality = encoder.add_column("quality", ColumnType::UINT64, true);
+}
+
+void FrameColumnSchema::set(ColumnEncoder &encoder, FrameResult result, const DecodedFrame *frame) const {
+  encoder.set(this->result, (uint8_t) result);
+  if (frame == nullptr)
+    return;
+  if (frame->is_available(FIELD_WIND_DIRECTION)) {
+    encoder.set(this->wind_direction, frame->wind_direction);
+    encoder.set(this->compass_direction, ((frame->wind_direction % 360) * 16 + 180) / 360 % 16);
+  }
+  encoder.set(this->low_battery, frame->low_battery);
+  if (frame->is_available(FIELD_TEMPERATURE))
+    encoder.set(this->temperature, frame->temperature);
+  if (frame->is_available(FIELD_HUMIDITY))
+    encoder.set(this->humidity, frame->humidity);
+  if (frame->is_available(FIELD_WIND_SPEED))
+    encoder.set(this->wind_speed, frame->wind_speed);
+  if (frame->is_available(FIELD_WIND_GUST))
+    encoder.set(this->wind_gust, frame->wind_gust);
+  encoder.set(this->precipitation, frame->precipitation);
+  if (frame->is_available(FIELD_UV_INTENSITY))
+    encoder.set(this->uv_intensity, frame->uv_intensity);
+  if (frame->is_available(FIELD_LIGHT))
+    encoder.set(this->light, frame->light);
+  if (frame->has_pressure)
+    encoder.set(this->pressure, frame->pressure);
+  encoder.set(this->quality, frame->quality);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
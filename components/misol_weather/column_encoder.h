@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "decoded_frame.h"
+#include "flight_recorder.h"
+
+namespace esphome {
+namespace misol_weather {
+
+enum class ColumnType : uint8_t {
+  UINT8 = 1,
+  UINT16,
+  UINT32,
+  UINT64,
+  INT32,
+  DICTIONARY,  // uint8 index into the labels of the column
+};
+
+class ColumnSink {
+ public:
+  virtual ~ColumnSink() = default;
+  virtual void write(const uint8_t *data, size_t length) = 0;
+};
+
+// Streaming column file, all numbers little endian:
+//   "MWCF", uint8 version 1, uint8 column count
+//   per column: uint8 name length, name, uint8 ColumnType, uint8 nullable, float64 scale, float64 offset,
+//     for dictionary columns uint8 label count and per label uint8 length and the label
+//   row groups: uint32 row count, then per column
+//     nullable columns: validity bitmap of (rows + 7) / 8 bytes, bit row % 8 of byte row / 8 set for values
+//     the values, row count times the type size, 0 for null
+//   uint32 0 after the last row group
+// Values are raw integers, the physical value is raw * scale + offset. Only one row group is kept in memory,
+// allocated with the first row.
+class ColumnEncoder {
+ public:
+  static const uint8_t MAX_COLUMNS = 32;
+
+  ColumnEncoder(ColumnSink *sink, uint16_t rows_per_group) : sink_(sink), rows_per_group_(rows_per_group) {}
+
+  // Columns are added before the first row, returns the column index
+  uint8_t add_column(const char *name, ColumnType type, bool nullable, double scale = 1.0, double offset = 0.0);
+  // labels have to outlive the encoder
+  uint8_t add_dictionary_column(const char *name, const char *const *labels, uint8_t label_count, bool nullable);
+  // Value of the column in the current row, columns not set are null (or 0 when not nullable)
+  void set(uint8_t column, uint64_t value);
+  void end_row();
+  // Writes the schema when there was no row, the last row group and the end marker
+  void finish();
+
+ protected:
+  struct Column {
+    const char *name;
+    ColumnType type;
+    uint8_t size;
+    bool nullable;
+    double scale;
+    double offset;
+    const char *const *labels;
+    uint8_t label_count;
+    std::unique_ptr<uint8_t[]> values;
+    std::unique_ptr<uint8_t[]> validity;
+  };
+
+  void write_schema_();
+  void write_group_();
+  void put_uint_(uint64_t value, uint8_t size);
+  void put_double_(double value);
+
+  ColumnSink *sink_;
+  uint16_t rows_per_group_;
+  Column columns_[MAX_COLUMNS];
+  uint8_t column_count_{0};
+  bool schema_written_{false};
+  uint16_t rows_{0};
+};
+
+// Columns of the decoded frame fields, fields the station reported as not available are null
+struct FrameColumnSchema {
+  uint8_t result;
+  uint8_t wind_direction;
+  uint8_t compass_direction;  // 16 points, without north correction
+  uint8_t low_battery;
+  uint8_t temperature;
+  uint8_t humidity;
+  uint8_t wind_speed;
+  uint8_t wind_gust;
+  uint8_t precipitation;
+  uint8_t uv_intensity;
+  uint8_t light;
+  uint8_t pressure;
+  uint8_t quality;
+
+  void add_to(ColumnEncoder &encoder);
+  // frame is nullptr for frames without values
+  void set(ColumnEncoder &encoder, FrameResult result, const DecodedFrame *frame) const;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,31 @@
+#include "compass_points_select.h"
+#ifdef USE_SELECT
+#include <cmath>
+#include <cstdlib>
+
+namespace esphome {
+namespace misol_weather {
+
+void CompassPointsSelect::setup() {
+  // Options are the number of points, "8" and "16"
+  int points;
+  this->pref_ = global_preferences->make_preference<int>(this->get_object_id_hash());
+  if (this->pref_.load(&points) && this->index_of(std::to_string(points)).has_value()) {
+    this->parent_->set_setting(SETTING_COMPASS_POINTS, points);
+  } else {
+    float setting = this->parent_->get_setting(SETTING_COMPASS_POINTS);
+    points = std::isnan(setting) ? 8 : (int) setting;
+  }
+  this->publish_state(std::to_string(points));
+}
+
+void CompassPointsSelect::control(const std::string &value) {
+  int points = atoi(value.c_str());
+  this->parent_->set_setting(SETTING_COMPASS_POINTS, points);
+  this->publish_state(value);
+  this->pref_.save(&points);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_SELECT
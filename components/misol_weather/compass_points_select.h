@@ -0,0 +1,28 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_SELECT
+#include <string>
+#include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/select/select.h"
+#include "weather_station.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Selects 8 or 16 points for the wind direction text sensor, the choice survives reboots
+class CompassPointsSelect : public select::Select, public Component, public Parented<WeatherStation> {
+ public:
+  void setup() override;
+  float get_setup_priority() const override { return setup_priority::HARDWARE; }
+
+ protected:
+  void control(const std::string &value) override;
+
+  ESPPreferenceObject pref_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_SELECT
@@ -0,0 +1,155 @@
+#include "decoded_frame.h"
+
+namespace esphome {
+namespace misol_weather {
+
+const char *field_to_string(Field field) {
+  switch (field) {
+    case FIELD_WIND_DIRECTION:
+      return "Wind direction";
+    case FIELD_LOW_BATTERY:
+      return "Battery level";
+    case FIELD_TEMPERATURE:
+      return "Temperature";
+    case FIELD_HUMIDITY:
+      return "Humidity";
+    case FIELD_WIND_SPEED:
+      return "Wind speed";
+    case FIELD_WIND_GUST:
+      return "Wind gust";
+    case FIELD_PRECIPITATION:
+      return "Precipitation";
+    case FIELD_UV_INTENSITY:
+      return "UV intensity";
+    case FIELD_LIGHT:
+      return "Light";
+    case FIELD_PRESSURE:
+      return "Pressure";
+    default:
+      return "Unknown";
+  }
+}
+
+float DecodedFrame::get_value(Field field) const {
+  switch (field) {
+    case FIELD_WIND_DIRECTION:
+      return this->get_wind_direction();
+    case FIELD_LOW_BATTERY:
+      return this->low_battery;
+    case FIELD_TEMPERATURE:
+      return this->get_temperature();
+    case FIELD_HUMIDITY:
+      return this->get_humidity();
+    case FIELD_WIND_SPEED:
+      return this->get_wind_speed();
+    case FIELD_WIND_GUST:
+      return this->get_wind_gust();
+    case FIELD_PRECIPITATION:
+      return this->get_accumulated_precipitation();
+    case FIELD_UV_INTENSITY:
+      return this->get_uv_intensity();
+    case FIELD_LIGHT:
+      return this->get_light();
+    case FIELD_PRESSURE:
+      return this->get_pressure();
+    default:
+      return NAN;
+  }
+}
+
+uint16_t DecodedFrame::get_degraded_fields() const {
+  uint16_t degraded = 0;
+  for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+    if (this->get_quality((Field) field) != 0)
+      degraded |= 1 << field;
+  }
+  return degraded;
+}
+
+uint16_t DecodedFrame::get_changed_fields(const DecodedFrame &other) const {
+  uint16_t changed = 0;
+  if (this->wind_direction != other.wind_direction)
+    changed |= 1 << FIELD_WIND_DIRECTION;
+  if (this->low_battery != other.low_battery)
+    changed |= 1 << FIELD_LOW_BATTERY;
+  if (this->temperature != other.temperature)
+    changed |= 1 << FIELD_TEMPERATURE;
+  if (this->humidity != other.humidity)
+    changed |= 1 << FIELD_HUMIDITY;
+  if (this->wind_speed != other.wind_speed)
+    changed |= 1 << FIELD_WIND_SPEED;
+  if (this->wind_gust != other.wind_gust)
+    changed |= 1 << FIELD_WIND_GUST;
+  if (this->precipitation != other.precipitation)
+    changed |= 1 << FIELD_PRECIPITATION;
+  if (this->uv_intensity != other.uv_intensity)
+    changed |= 1 << FIELD_UV_INTENSITY;
+  if (this->light != other.light)
+    changed |= 1 << FIELD_LIGHT;
+  if ((this->has_pressure != other.has_pressure) || (this->pressure != other.pressure))
+    changed |= 1 << FIELD_PRESSURE;
+  return changed;
+}
+
+bool DecodedFrame::is_available(Field field) const {
+  switch (field) {
+    case FIELD_WIND_DIRECTION:
+      return this->wind_direction != WIND_DIRECTION_NOT_AVAILABLE;
+    case FIELD_TEMPERATURE:
+      return this->temperature != TEMPERATURE_NOT_AVAILABLE;
+    case FIELD_HUMIDITY:
+      return this->humidity != HUMIDITY_NOT_AVAILABLE;
+    case FIELD_WIND_SPEED:
+      return this->wind_speed != WIND_SPEED_NOT_AVAILABLE;
+    case FIELD_WIND_GUST:
+      return this->wind_gust != WIND_GUST_NOT_AVAILABLE;
+    case FIELD_UV_INTENSITY:
+      return this->uv_intensity != UV_INTENSITY_NOT_AVAILABLE;
+    case FIELD_LIGHT:
+      return this->light != LIGHT_NOT_AVAILABLE;
+    case FIELD_PRESSURE:
+      return this->has_pressure;
+    default:
+      return true;
+  }
+}
+
+void decode_frame(const uint8_t *data, size_t len, bool has_pressure, DecodedFrame &frame) {
+  frame.security_code = data[1];
+  frame.wind_direction = data[2] + (((uint16_t) (data[3] & 0x80)) << 1);
+  frame.low_battery = (data[3] & 0x08) != 0;
+  frame.temperature = data[4] + (((uint16_t) (data[3] & 0x07)) << 8);
+  frame.humidity = data[5];
+  frame.wind_speed = data[6] + (((uint16_t) (data[3] & 0x10)) << 4);
+  frame.wind_gust = data[7];
+  frame.precipitation = data[9] + (((uint16_t) data[8]) << 8);
+  frame.uv_intensity = data[11] + (((uint16_t) data[10]) << 8);
+  frame.light = data[14] + (((uint32_t) data[13]) << 8) + (((uint32_t) data[12]) << 16);
+  frame.has_pressure = has_pressure && (len >= 21);
+  if (frame.has_pressure) {
+    frame.pressure = (((uint32_t) data[17]) << 16) + (((uint32_t) data[18]) << 8) + data[19];
+  } else {
+    frame.pressure = 0;
+  }
+  frame.quality = 0;
+  for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+    if ((field != FIELD_PRESSURE) && !frame.is_available((Field) field))
+      frame.add_quality((Field) field, QUALITY_SENTINEL);
+  }
+  // Measurement ranges from the station specification, wider values are decoding artifacts
+  if ((frame.wind_direction != WIND_DIRECTION_NOT_AVAILABLE) && (frame.wind_direction > 359))
+    frame.add_quality(FIELD_WIND_DIRECTION, QUALITY_OUT_OF_RANGE);
+  if ((frame.temperature != TEMPERATURE_NOT_AVAILABLE) && (frame.temperature > 1000))
+    frame.add_quality(FIELD_TEMPERATURE, QUALITY_OUT_OF_RANGE);
+  if ((frame.humidity != HUMIDITY_NOT_AVAILABLE) && (frame.humidity > 100))
+    frame.add_quality(FIELD_HUMIDITY, QUALITY_OUT_OF_RANGE);
+  if ((frame.wind_speed != WIND_SPEED_NOT_AVAILABLE) && (frame.wind_speed > 357))
+    frame.add_quality(FIELD_WIND_SPEED, QUALITY_OUT_OF_RANGE);
+  if ((frame.light != LIGHT_NOT_AVAILABLE) && (frame.light > 2000000))
+    frame.add_quality(FIELD_LIGHT, QUALITY_OUT_OF_RANGE);
+  if (frame.has_pressure && ((frame.pressure < 30000) || (frame.pressure > 110000)))
+    frame.add_quality(FIELD_PRESSURE, QUALITY_OUT_OF_RANGE);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
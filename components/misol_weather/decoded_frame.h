@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+static const uint16_t WIND_DIRECTION_NOT_AVAILABLE = 0x1FF;
+static const uint16_t TEMPERATURE_NOT_AVAILABLE = 0x7FF;
+static const uint8_t HUMIDITY_NOT_AVAILABLE = 0xFF;
+static const uint16_t WIND_SPEED_NOT_AVAILABLE = 0x1FF;
+static const uint8_t WIND_GUST_NOT_AVAILABLE = 0xFF;
+static const uint16_t UV_INTENSITY_NOT_AVAILABLE = 0xFFFF;
+static const uint32_t LIGHT_NOT_AVAILABLE = 0xFFFFFF;
+
+enum Field : uint8_t {
+  FIELD_WIND_DIRECTION = 0,
+  FIELD_LOW_BATTERY,
+  FIELD_TEMPERATURE,
+  FIELD_HUMIDITY,
+  FIELD_WIND_SPEED,
+  FIELD_WIND_GUST,
+  FIELD_PRECIPITATION,
+  FIELD_UV_INTENSITY,
+  FIELD_LIGHT,
+  FIELD_PRESSURE,
+  FIELD_COUNT,
+};
+
+const char *field_to_string(Field field);
+
+// Mask of fields (1 << Field), usable in constant expressions
+template<typename... Fields> constexpr uint16_t field_mask(Fields... fields) { return ((1 << fields) | ... | 0); }
+
+// Per field data quality, 4 bits for every field
+enum QualityFlag : uint8_t {
+  QUALITY_SENTINEL = 1 << 0,      // station reported the value as not available
+  QUALITY_OUT_OF_RANGE = 1 << 1,  // value is outside of the sensor specification or configured plausible range
+  QUALITY_FILTERED = 1 << 2,      // value was replaced by the outlier filter
+  QUALITY_STALE = 1 << 3,         // no valid value for longer than the communication timeout
+};
+static const uint8_t QUALITY_BITS_PER_FIELD = 4;
+
+// Frame fields in the units used on the wire. Kept as integers so the frame
+// can be compared, filtered and stored without floating point conversions.
+struct DecodedFrame {
+  uint8_t security_code{0};
+  bool low_battery{false};
+  bool has_pressure{false};
+  uint16_t wind_direction{WIND_DIRECTION_NOT_AVAILABLE};  // degrees
+  uint16_t temperature{TEMPERATURE_NOT_AVAILABLE};        // 0.1 °C with +40 °C offset
+  uint8_t humidity{HUMIDITY_NOT_AVAILABLE};               // %
+  uint16_t wind_speed{WIND_SPEED_NOT_AVAILABLE};          // 0.14 m/s
+  uint8_t wind_gust{WIND_GUST_NOT_AVAILABLE};             // 1.12 m/s
+  uint16_t precipitation{0};                              // 0.3 mm rain gauge ticks
+  uint16_t uv_intensity{UV_INTENSITY_NOT_AVAILABLE};      // 0.1 mW/m²
+  uint32_t light{LIGHT_NOT_AVAILABLE};                    // 0.1 lux
+  uint32_t pressure{0};                                   // 0.01 hPa
+  uint64_t quality{0};                                    // QualityFlag bits of every field
+  int64_t epoch_ms{0};                                    // UTC time of the first byte, 0 when unknown
+
+  float get_wind_direction() const {
+    return (this->wind_direction != WIND_DIRECTION_NOT_AVAILABLE) ? this->wind_direction : NAN;
+  }
+  float get_temperature() const {
+    return (this->temperature != TEMPERATURE_NOT_AVAILABLE) ? (this->temperature - 400) / 10.0 : NAN;
+  }
+  float get_humidity() const { return (this->humidity != HUMIDITY_NOT_AVAILABLE) ? this->humidity : NAN; }
+  float get_wind_speed() const {
+    return (this->wind_speed != WIND_SPEED_NOT_AVAILABLE) ? this->wind_speed / 8.0 * 1.12 : NAN;
+  }
+  float get_wind_gust() const { return (this->wind_gust != WIND_GUST_NOT_AVAILABLE) ? this->wind_gust * 1.12 : NAN; }
+  float get_accumulated_precipitation() const { return this->precipitation * 0.3; }
+  float get_uv_intensity() const {
+    return (this->uv_intensity != UV_INTENSITY_NOT_AVAILABLE) ? this->uv_intensity / 10.0 : NAN;
+  }
+  float get_uv_index() const {
+    return (this->uv_intensity != UV_INTENSITY_NOT_AVAILABLE) ? (uint8_t) (this->uv_intensity / 400) : NAN;
+  }
+  float get_light() const { return (this->light != LIGHT_NOT_AVAILABLE) ? this->light / 10.0 : NAN; }
+  float get_pressure() const { return this->has_pressure ? this->pressure / 100.0f : NAN; }
+  // Physical value of the field, NAN when not available
+  float get_value(Field field) const;
+  // False when the station reported the field as not available
+  bool is_available(Field field) const;
+  uint8_t get_quality(Field field) const {
+    return (this->quality >> (field * QUALITY_BITS_PER_FIELD)) & ((1 << QUALITY_BITS_PER_FIELD) - 1);
+  }
+  void add_quality(Field field, uint8_t flags) {
+    this->quality |= ((uint64_t) flags) << (field * QUALITY_BITS_PER_FIELD);
+  }
+  void add_quality(uint16_t fields, uint8_t flags) {
+    for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+      if (fields & (1 << field))
+        this->add_quality((Field) field, flags);
+    }
+  }
+  // Mask of fields (1 << Field) with any quality flag set
+  uint16_t get_degraded_fields() const;
+  // Mask of fields (1 << Field) with a different raw value in the other frame
+  uint16_t get_changed_fields(const DecodedFrame &other) const;
+};
+
+// Extracts fields from a packet that already passed the checksum check
+void decode_frame(const uint8_t *data, size_t len, bool has_pressure, DecodedFrame &frame);
+
+}  // namespace misol_weather
+}  // namespace esphome
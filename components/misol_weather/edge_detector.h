@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+enum class Edge : uint8_t {
+  NONE = 0,
+  RISING,
+  FALLING,
+};
+
+// Detects a value crossing a threshold band. The value has to rise above the upper threshold to become high
+// and fall below the lower one to become low again, the first value only sets the initial state.
+class CrossingDetector {
+ public:
+  CrossingDetector(float lower_threshold, float upper_threshold)
+      : lower_threshold_(lower_threshold), upper_threshold_(upper_threshold) {}
+
+  Edge update(float value) {
+    if (std::isnan(value))
+      return Edge::NONE;
+    if (!this->has_state_) {
+      this->high_ = value > this->upper_threshold_;
+      this->has_state_ = true;
+      return Edge::NONE;
+    }
+    if (!this->high_ && (value > this->upper_threshold_)) {
+      this->high_ = true;
+      return Edge::RISING;
+    }
+    if (this->high_ && (value < this->lower_threshold_)) {
+      this->high_ = false;
+      return Edge::FALLING;
+    }
+    return Edge::NONE;
+  }
+  bool is_high() const { return this->high_; }
+
+ protected:
+  float lower_threshold_;
+  float upper_threshold_;
+  bool has_state_{false};
+  bool high_{false};
+};
+
+// Tracks rain from the rain gauge counter: the first tip starts the rain, it stops after the dry time
+// passes without a tip. A counter going backwards (station restart) only resynchronizes the detector.
+class RainDetector {
+ public:
+  // More tips between two frames are not plausible and are treated as a counter jump
+  static const uint16_t MAX_TIPS_PER_FRAME = 100;
+
+  explicit RainDetector(uint32_t dry_time_ms) : dry_time_ms_(dry_time_ms) {}
+
+  Edge update(uint16_t counter, uint32_t timestamp_ms) {
+    if (!this->has_counter_) {
+      this->counter_ = counter;
+      this->has_counter_ = true;
+      return Edge::NONE;
+    }
+    uint16_t tips = counter - this->counter_;
+    this->counter_ = counter;
+    if ((tips > 0) && (tips <= MAX_TIPS_PER_FRAME)) {
+      this->last_tip_ms_ = timestamp_ms;
+      if (!this->raining_) {
+        this->raining_ = true;
+        return Edge::RISING;
+      }
+      return Edge::NONE;
+    }
+    if (this->raining_ && ((uint32_t) (timestamp_ms - this->last_tip_ms_) >= this->dry_time_ms_)) {
+      this->raining_ = false;
+      return Edge::FALLING;
+    }
+    return Edge::NONE;
+  }
+  bool is_raining() const { return this->raining_; }
+
+ protected:
+  uint32_t dry_time_ms_;
+  bool has_counter_{false};
+  uint16_t counter_{0};
+  bool raining_{false};
+  uint32_t last_tip_ms_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,31 @@
+#include "fault_detector.h"
+#include <cmath>
+
+namespace esphome {
+namespace misol_weather {
+
+// Longer gaps between frames (communication problems) do not count towards the flat line duration
+static const uint32_t MAX_FRAME_INTERVAL_MS = 5 * 60 * 1000;
+
+void FaultDetector::update(float value, uint32_t timestamp_ms, bool conditions_changed) {
+  if (std::isnan(value))
+    return;
+  this->out_of_range_ = (value < this->min_value_) || (value > this->max_value_);
+  if (this->has_last_value_ && (value == this->last_value_)) {
+    if (conditions_changed) {
+      uint32_t interval = timestamp_ms - this->last_timestamp_ms_;
+      if (interval > MAX_FRAME_INTERVAL_MS)
+        interval = MAX_FRAME_INTERVAL_MS;
+      if (this->flat_duration_ms_ <= UINT32_MAX - interval)
+        this->flat_duration_ms_ += interval;
+    }
+  } else {
+    this->flat_duration_ms_ = 0;
+  }
+  this->has_last_value_ = true;
+  this->last_value_ = value;
+  this->last_timestamp_ms_ = timestamp_ms;
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Detects a sensor stuck at the same value while other conditions keep changing, and values
+// outside of the physically plausible range. Keeps only the last value and a duration counter.
+class FaultDetector {
+ public:
+  FaultDetector(uint32_t flat_line_duration_ms, float min_value, float max_value)
+      : flat_line_duration_ms_(flat_line_duration_ms), min_value_(min_value), max_value_(max_value) {}
+  // NAN values are ignored. conditions_changed tells if other measurements changed since the previous frame.
+  void update(float value, uint32_t timestamp_ms, bool conditions_changed);
+  bool is_flat_line() const { return this->flat_duration_ms_ > this->flat_line_duration_ms_; }
+  bool is_out_of_range() const { return this->out_of_range_; }
+  bool has_fault() const { return this->is_flat_line() || this->out_of_range_; }
+
+ protected:
+  uint32_t flat_line_duration_ms_;
+  float min_value_;
+  float max_value_;
+  bool has_last_value_{false};
+  bool out_of_range_{false};
+  float last_value_{0};
+  uint32_t last_timestamp_ms_{0};
+  uint32_t flat_duration_ms_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#include "flight_recorder.h"
+#include <cstring>
+
+namespace esphome {
+namespace misol_weather {
+
+const char *frame_result_to_string(FrameResult result) {
+  switch (result) {
+    case FrameResult::BASIC_PACKET:
+      return "OK";
+    case FrameResult::BASIC_WITH_PRESSURE:
+      return "OK with pressure";
+    case FrameResult::PRESSURE_CHECKSUM_FAILURE:
+      return "Pressure checksum failure";
+    case FrameResult::CHECKSUM_FAILURE:
+      return "Checksum failure";
+    case FrameResult::TRUNCATED:
+      return "Truncated";
+    default:
+      return "Unknown";
+  }
+}
+
+void FlightRecorder::init(uint8_t capacity, bool keep_processed) {
+  this->frames_.reset(capacity > 0 ? new RecordedFrame[capacity] : nullptr);
+  this->processed_.reset((capacity > 0) && keep_processed ? new DecodedFrame[capacity] : nullptr);
+  this->capacity_ = capacity;
+  this->count_ = 0;
+  this->next_ = 0;
+}
+
+void FlightRecorder::record(const uint8_t *data, size_t length, uint32_t timestamp_ms, FrameResult result) {
+  if (this->capacity_ == 0)
+    return;
+  RecordedFrame &frame = this->frames_[this->next_];
+  frame.timestamp_ms = timestamp_ms;
+  frame.result = result;
+  frame.processed = false;
+  frame.length = length < RecordedFrame::MAX_LENGTH ? length : RecordedFrame::MAX_LENGTH;
+  memcpy(frame.data, data, frame.length);
+  this->next_ = (this->next_ + 1) % this->capacity_;
+  if (this->count_ < this->capacity_)
+    this->count_++;
+}
+
+void FlightRecorder::set_processed(const DecodedFrame &frame) {
+  if ((this->processed_ == nullptr) || (this->count_ == 0))
+    return;
+  uint8_t last = (this->next_ + this->capacity_ - 1) % this->capacity_;
+  this->processed_[last] = frame;
+  this->frames_[last].processed = true;
+}
+
+uint8_t FlightRecorder::slot_(uint8_t index) const {
+  return (this->next_ + this->capacity_ - this->count_ + index) % this->capacity_;
+}
+
+const RecordedFrame &FlightRecorder::get(uint8_t index) const { return this->frames_[this->slot_(index)]; }
+
+const DecodedFrame *FlightRecorder::get_processed(uint8_t index) const {
+  uint8_t slot = this->slot_(index);
+  return this->frames_[slot].processed && (this->processed_ != nullptr) ? &this->processed_[slot] : nullptr;
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
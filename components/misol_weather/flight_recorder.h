@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "decoded_frame.h"
+
+namespace esphome {
+namespace misol_weather {
+
+enum class FrameResult : uint8_t {
+  BASIC_PACKET = 0,
+  BASIC_WITH_PRESSURE,
+  PRESSURE_CHECKSUM_FAILURE,
+  CHECKSUM_FAILURE,
+  TRUNCATED,
+};
+
+const char *frame_result_to_string(FrameResult result);
+
+struct RecordedFrame {
+  static const uint8_t MAX_LENGTH = 21;
+
+  uint32_t timestamp_ms;
+  FrameResult result;
+  bool processed;  // set_processed() stored the frame after filtering
+  uint8_t length;
+  uint8_t data[MAX_LENGTH];
+};
+
+// Ring of the last received frames. Storage is allocated once, recording is a single copy
+// and nothing is formatted until the content is requested.
+class FlightRecorder {
+ public:
+  // keep_processed also allocates a decoded frame per record for set_processed()
+  void init(uint8_t capacity, bool keep_processed = false);
+  bool is_enabled() const { return this->capacity_ > 0; }
+  void record(const uint8_t *data, size_t length, uint32_t timestamp_ms, FrameResult result);
+  // Frame with the filtered values and the final quality flags of the last recorded frame
+  void set_processed(const DecodedFrame &frame);
+  uint8_t size() const { return this->count_; }
+  // Index 0 is the oldest frame
+  const RecordedFrame &get(uint8_t index) const;
+  // nullptr when the frame was not processed or processed frames are not kept
+  const DecodedFrame *get_processed(uint8_t index) const;
+
+ protected:
+  uint8_t slot_(uint8_t index) const;
+
+  std::unique_ptr<RecordedFrame[]> frames_;
+  std::unique_ptr<DecodedFrame[]> processed_;
+  uint8_t capacity_{0};
+  uint8_t count_{0};
+  uint8_t next_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
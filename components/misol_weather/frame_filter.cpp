@@ -0,0 +1,53 @@
+#include "frame_filter.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Deviations below these limits (in raw units) are never treated as outliers,
+// otherwise a perfectly flat window would reject any change
+static const uint16_t TEMPERATURE_MIN_DEVIATION = 30;  // 3 °C
+static const uint8_t HUMIDITY_MIN_DEVIATION = 10;      // 10 %
+static const uint16_t WIND_SPEED_MIN_DEVIATION = 40;   // 5.6 m/s
+static const uint8_t WIND_GUST_MIN_DEVIATION = 5;      // 5.6 m/s
+static const uint16_t UV_INTENSITY_MIN_DEVIATION = 2000;  // 200 mW/m²
+static const uint32_t LIGHT_MIN_DEVIATION = 200000;       // 20 klx
+static const uint32_t PRESSURE_MIN_DEVIATION = 300;       // 3 hPa
+
+FrameFilter::FrameFilter(OutlierFilterMethod method, uint8_t window_size, float threshold) {
+  this->temperature_.configure(method, window_size, threshold, TEMPERATURE_MIN_DEVIATION);
+  this->humidity_.configure(method, window_size, threshold, HUMIDITY_MIN_DEVIATION);
+  this->wind_speed_.configure(method, window_size, threshold, WIND_SPEED_MIN_DEVIATION);
+  this->wind_gust_.configure(method, window_size, threshold, WIND_GUST_MIN_DEVIATION);
+  this->uv_intensity_.configure(method, window_size, threshold, UV_INTENSITY_MIN_DEVIATION);
+  this->light_.configure(method, window_size, threshold, LIGHT_MIN_DEVIATION);
+  this->pressure_.configure(method, window_size, threshold, PRESSURE_MIN_DEVIATION);
+}
+
+uint16_t FrameFilter::apply(DecodedFrame &frame) {
+  uint16_t mask = 0;
+  this->apply_field_(frame, FIELD_TEMPERATURE, this->temperature_, frame.temperature, mask);
+  this->apply_field_(frame, FIELD_HUMIDITY, this->humidity_, frame.humidity, mask);
+  this->apply_field_(frame, FIELD_WIND_SPEED, this->wind_speed_, frame.wind_speed, mask);
+  this->apply_field_(frame, FIELD_WIND_GUST, this->wind_gust_, frame.wind_gust, mask);
+  this->apply_field_(frame, FIELD_UV_INTENSITY, this->uv_intensity_, frame.uv_intensity, mask);
+  this->apply_field_(frame, FIELD_LIGHT, this->light_, frame.light, mask);
+  this->apply_field_(frame, FIELD_PRESSURE, this->pressure_, frame.pressure, mask);
+  return mask;
+}
+
+template<typename T>
+void FrameFilter::apply_field_(const DecodedFrame &frame, Field field, OutlierFilter<T> &filter, T &value,
+                               uint16_t &mask) {
+  // Values reported as not available are passed through and do not enter the window
+  if (!(this->enabled_fields_ & (1 << field)) || !frame.is_available(field))
+    return;
+  bool rejected;
+  value = filter.apply(value, rejected);
+  if (rejected) {
+    this->rejections_++;
+    mask |= 1 << field;
+  }
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include "decoded_frame.h"
+#include "outlier_filter.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Outlier filter stage applied to decoded frames before anything is derived from them.
+// Wind direction and precipitation counter are not filtered.
+class FrameFilter {
+ public:
+  FrameFilter(OutlierFilterMethod method, uint8_t window_size, float threshold);
+  void enable_field(Field field) { this->enabled_fields_ |= 1 << field; }
+  // Replaces outliers in the frame, returns the mask of replaced fields
+  uint16_t apply(DecodedFrame &frame);
+  uint32_t get_rejections() const { return this->rejections_; }
+
+ protected:
+  template<typename T>
+  void apply_field_(const DecodedFrame &frame, Field field, OutlierFilter<T> &filter, T &value, uint16_t &mask);
+
+  uint16_t enabled_fields_{0};
+  uint32_t rejections_{0};
+  OutlierFilter<uint16_t> temperature_;
+  OutlierFilter<uint8_t> humidity_;
+  OutlierFilter<uint16_t> wind_speed_;
+  OutlierFilter<uint8_t> wind_gust_;
+  OutlierFilter<uint16_t> uv_intensity_;
+  OutlierFilter<uint32_t> light_;
+  OutlierFilter<uint32_t> pressure_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,41 @@
+#include "frame_mqtt_sensor.h"
+#if defined(USE_MQTT) && defined(USE_SENSOR)
+#include "esphome/components/mqtt/mqtt_const.h"
+
+namespace esphome {
+namespace misol_weather {
+
+bool FrameMQTTSensor::reads_frame_() const {
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+  return (this->frame_key_ != nullptr) && !this->parent_->get_mqtt_frame_entity_states();
+#else
+  return false;
+#endif
+}
+
+void FrameMQTTSensor::setup() {
+  // Registers the state callback that publishes the state
+  if (!this->reads_frame_())
+    MQTTSensorComponent::setup();
+}
+
+bool FrameMQTTSensor::send_initial_state() {
+  if (!this->reads_frame_())
+    return MQTTSensorComponent::send_initial_state();
+  return true;
+}
+
+void FrameMQTTSensor::send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) {
+  MQTTSensorComponent::send_discovery(root, config);
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+  if (!this->reads_frame_())
+    return;
+  config.state_topic = false;
+  root[mqtt::MQTT_STATE_TOPIC] = this->parent_->get_mqtt_frame_topic();
+  root[mqtt::MQTT_VALUE_TEMPLATE] = str_sprintf("{{ value_json.%s }}", this->frame_key_);
+#endif
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_MQTT && USE_SENSOR
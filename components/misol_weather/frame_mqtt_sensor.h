@@ -0,0 +1,35 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#if defined(USE_MQTT) && defined(USE_SENSOR)
+#include "esphome/components/mqtt/mqtt_sensor.h"
+#include "weather_station.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// MQTT component of the sensors whose value is in the frame message. With mqtt_frame and entity_states off the state
+// is not published, the discovery message points to the frame topic with a value template instead. Otherwise it
+// behaves like the MQTT component of any sensor.
+class FrameMQTTSensor : public mqtt::MQTTSensorComponent {
+ public:
+  explicit FrameMQTTSensor(sensor::Sensor *sensor) : MQTTSensorComponent(sensor) {}
+
+  void set_frame_key(WeatherStation *parent, const char *key) {
+    this->parent_ = parent;
+    this->frame_key_ = key;
+  }
+  void setup() override;
+  bool send_initial_state() override;
+  void send_discovery(JsonObject root, mqtt::SendDiscoveryConfig &config) override;
+
+ protected:
+  bool reads_frame_() const;
+
+  WeatherStation *parent_{nullptr};
+  const char *frame_key_{nullptr};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_MQTT && USE_SENSOR
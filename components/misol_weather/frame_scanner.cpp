@@ -0,0 +1,39 @@
+#include "frame_scanner.h"
+
+namespace esphome {
+namespace misol_weather {
+
+PacketType check_packet(const uint8_t *data, size_t len) {
+  // Checking basic packet
+  if (len < BASIC_PACKET_SIZE) {
+    return PacketType::WRONG_PACKET;
+  }
+  if (data[0] != PACKET_HEADER) {
+    return PacketType::WRONG_PACKET;
+  }
+  uint8_t checksum = 0;
+  for (int i = 0; i < 16; i++) {
+    checksum += data[i];
+  }
+  if (checksum != data[16]) {
+    return PacketType::WRONG_PACKET;
+  }
+  // Checking barometry pressure packet
+  if (len > BASIC_PACKET_SIZE) {
+    if (len < PRESSURE_PACKET_SIZE) {
+      return PacketType::BASIC_PACKET;
+    }
+    checksum = 0;
+    for (int i = 17; i < 20; i++) {
+      checksum += data[i];
+    }
+    if (checksum != data[20]) {
+      return PacketType::BASIC_PACKET;
+    }
+    return PacketType::BASIC_WITH_PRESSURE;
+  }
+  return PacketType::BASIC_PACKET;
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
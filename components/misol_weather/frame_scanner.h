@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "flight_recorder.h"
+
+namespace esphome {
+namespace misol_weather {
+
+enum class PacketType {
+  WRONG_PACKET = -1,
+  BASIC_PACKET = 0,
+  BASIC_WITH_PRESSURE,
+};
+
+static const uint8_t PACKET_HEADER = 0x24;
+static const size_t BASIC_PACKET_SIZE = 17;
+static const size_t PRESSURE_PACKET_SIZE = 21;
+
+// Validates the header and the checksums of a frame starting at data, len is the number of bytes available
+PacketType check_packet(const uint8_t *data, size_t len);
+
+// Splits received bytes into frames, shared by the component and the host tools so both find the same frames.
+// on_frame(offset, length, result) is called for every frame, truncated frames and checksum failures included,
+// on_discard(count, in_sync) for skipped bytes, in_sync is set when the bytes end a synchronized run.
+// Without flush a tail that can be the beginning of a frame still being received is kept, as well as a frame with a
+// corrupted pressure trailer until it is known whether the next frame starts within the trailer.
+// in_sync carries the synchronization state from the previous call, so a stream scanned in pieces gives the same
+// result as scanned at once. Returns the number of bytes consumed.
+template<typename CheckPacket, typename OnFrame, typename OnDiscard>
+size_t scan_frames(const uint8_t *buffer, size_t length, bool flush, CheckPacket &&check, OnFrame &&on_frame,
+                   OnDiscard &&on_discard, bool &in_sync) {
+  size_t offset = 0;
+  while (offset < length) {
+    const uint8_t *data = buffer + offset;
+    size_t remaining = length - offset;
+    if (!flush && (remaining < PRESSURE_PACKET_SIZE)) {
+      break;
+    }
+    if (data[0] != PACKET_HEADER) {
+      on_discard(1, in_sync);
+      in_sync = false;
+      offset++;
+      continue;
+    }
+    if (remaining < BASIC_PACKET_SIZE) {
+      on_frame(offset, remaining, FrameResult::TRUNCATED);
+      on_discard(remaining, in_sync);
+      in_sync = false;
+      offset += remaining;
+      break;
+    }
+    PacketType packet_type = check(data, remaining);
+    if (packet_type == PacketType::WRONG_PACKET) {
+      if (in_sync) {
+        // Header bytes found while searching for the next frame are not counted
+        on_frame(offset, remaining, FrameResult::CHECKSUM_FAILURE);
+      }
+      on_discard(1, in_sync);
+      in_sync = false;
+      offset++;
+      continue;
+    }
+    size_t packet_size = BASIC_PACKET_SIZE;
+    FrameResult result = FrameResult::BASIC_PACKET;
+    if (packet_type == PacketType::BASIC_WITH_PRESSURE) {
+      packet_size = PRESSURE_PACKET_SIZE;
+      result = FrameResult::BASIC_WITH_PRESSURE;
+    } else if ((remaining >= PRESSURE_PACKET_SIZE) && (data[BASIC_PACKET_SIZE] != PACKET_HEADER)) {
+      // Pressure trailer is present but corrupted, basic part is still usable. A trailer that lost a byte is followed
+      // by the next frame, whose header is then within the 4 bytes: the basic part is taken alone and the scanner
+      // resyncs to that frame.
+      bool next_frame = false;
+      bool wait = false;
+      for (size_t i = BASIC_PACKET_SIZE + 1; (i < PRESSURE_PACKET_SIZE) && !next_frame && !wait; i++) {
+        if (data[i] != PACKET_HEADER)
+          continue;
+        if (!flush && (remaining < i + BASIC_PACKET_SIZE)) {
+          wait = true;
+        } else {
+          next_frame = check(data + i, remaining - i) != PacketType::WRONG_PACKET;
+        }
+      }
+      if (wait) {
+        // The rest of the next frame is still being received
+        break;
+      }
+      if (!next_frame) {
+        packet_size = PRESSURE_PACKET_SIZE;
+        result = FrameResult::PRESSURE_CHECKSUM_FAILURE;
+      }
+    }
+    in_sync = true;
+    on_frame(offset, packet_size, result);
+    offset += packet_size;
+  }
+  return offset;
+}
+
+// Starts synchronized on every call
+template<typename CheckPacket, typename OnFrame, typename OnDiscard>
+size_t scan_frames(const uint8_t *buffer, size_t length, bool flush, CheckPacket &&check, OnFrame &&on_frame,
+                   OnDiscard &&on_discard) {
+  bool in_sync = true;
+  return scan_frames(buffer, length, flush, check, on_frame, on_discard, in_sync);
+}
+
+template<typename OnFrame, typename OnDiscard>
+size_t scan_frames(const uint8_t *buffer, size_t length, bool flush, OnFrame &&on_frame, OnDiscard &&on_discard) {
+  return scan_frames(buffer, length, flush, check_packet, on_frame, on_discard);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,272 @@
+#include "frame_serializer.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace misol_weather {
+
+namespace {
+
+class TextWriter {
+ public:
+  TextWriter(uint8_t *buffer, size_t size) : buffer_(reinterpret_cast<char *>(buffer)), size_(size) {}
+
+ protected:
+  template<typename... Args> void printf_(const char *format, Args... args) {
+    if (this->overflow_)
+      return;
+    int written = snprintf(this->buffer_ + this->length_, this->size_ - this->length_, format, args...);
+    if ((written < 0) || ((size_t) written >= this->size_ - this->length_)) {
+      this->overflow_ = true;
+      return;
+    }
+    this->length_ += written;
+  }
+  void append_(const char *data, size_t length) {
+    if (this->overflow_ || (this->length_ + length > this->size_)) {
+      this->overflow_ = true;
+      return;
+    }
+    memcpy(this->buffer_ + this->length_, data, length);
+    this->length_ += length;
+  }
+  size_t finish_() const { return this->overflow_ ? 0 : this->length_; }
+
+  char *buffer_;
+  size_t size_;
+  size_t length_{0};
+  bool overflow_{false};
+};
+
+class JsonWriter : public TextWriter {
+ public:
+  using TextWriter::TextWriter;
+
+  void begin() { this->append_("{", 1); }
+  void add_time(int64_t epoch_ms) {
+    if (epoch_ms > 0)
+      this->add_uint("time", epoch_ms);
+  }
+  void add_float(const char *key, float value, uint8_t decimals) {
+    if (std::isnan(value)) {
+      this->printf_("%s\"%s\":null", this->separator_(), key);
+    } else {
+      this->printf_("%s\"%s\":%.*f", this->separator_(), key, decimals, value);
+    }
+  }
+  void add_uint(const char *key, uint64_t value) {
+    this->printf_("%s\"%s\":%" PRIu64, this->separator_(), key, value);
+  }
+  void add_bool(const char *key, bool value) {
+    this->printf_("%s\"%s\":%s", this->separator_(), key, value ? "true" : "false");
+  }
+  size_t end() {
+    this->append_("}", 1);
+    return this->finish_();
+  }
+
+ protected:
+  const char *separator_() {
+    bool first = this->first_;
+    this->first_ = false;
+    return first ? "" : ",";
+  }
+
+  bool first_{true};
+};
+
+// InfluxDB line protocol: prefix is the measurement with optional tags, values that are not available are left out
+// as the protocol has no null. The time stamp has nanosecond precision, without it the server time is used.
+class LineProtocolWriter : public TextWriter {
+ public:
+  LineProtocolWriter(uint8_t *buffer, size_t size, const char *prefix) : TextWriter(buffer, size), prefix_(prefix) {}
+
+  void begin() { this->printf_("%s ", this->prefix_); }
+  void add_time(int64_t epoch_ms) { this->epoch_ms_ = epoch_ms; }
+  void add_float(const char *key, float value, uint8_t decimals) {
+    if (!std::isnan(value))
+      this->printf_("%s%s=%.*f", this->separator_(), key, decimals, value);
+  }
+  void add_uint(const char *key, uint64_t value) { this->printf_("%s%s=%" PRIu64 "i", this->separator_(), key, value); }
+  void add_bool(const char *key, bool value) {
+    this->printf_("%s%s=%s", this->separator_(), key, value ? "true" : "false");
+  }
+  size_t end() {
+    if (this->epoch_ms_ > 0)
+      this->printf_(" %" PRId64 "000000", this->epoch_ms_);
+    this->append_("\n", 1);
+    return this->finish_();
+  }
+
+ protected:
+  const char *separator_() {
+    bool first = this->first_;
+    this->first_ = false;
+    return first ? "" : ",";
+  }
+
+  const char *prefix_;
+  int64_t epoch_ms_{0};
+  bool first_{true};
+};
+
+// Prometheus text exposition format, prefix is prepended to the metric names. Every value is a gauge, values
+// that are not available are left out.
+class PrometheusWriter : public TextWriter {
+ public:
+  PrometheusWriter(uint8_t *buffer, size_t size, const char *prefix) : TextWriter(buffer, size), prefix_(prefix) {}
+
+  void begin() {}
+  void add_time(int64_t epoch_ms) {
+    if (epoch_ms > 0)
+      this->add_float("time_seconds", epoch_ms / 1000.0, 3);
+  }
+  void add_float(const char *key, double value, uint8_t decimals) {
+    if (!std::isnan(value))
+      this->printf_("# TYPE %s%s gauge\n%s%s %.*f\n", this->prefix_, key, this->prefix_, key, decimals, value);
+  }
+  void add_uint(const char *key, uint64_t value) {
+    this->printf_("# TYPE %s%s gauge\n%s%s %" PRIu64 "\n", this->prefix_, key, this->prefix_, key, value);
+  }
+  void add_bool(const char *key, bool value) { this->add_uint(key, value ? 1 : 0); }
+  size_t end() { return this->finish_(); }
+
+ protected:
+  const char *prefix_;
+};
+
+// RFC 8949 indefinite length map, floats are written in single precision
+class CborWriter {
+ public:
+  static const uint8_t MAJOR_UNSIGNED = 0;
+  static const uint8_t MAJOR_TEXT = 3;
+  static const uint8_t INDEFINITE_MAP = 0xBF;
+  static const uint8_t BREAK = 0xFF;
+  static const uint8_t SIMPLE_FALSE = 0xF4;
+  static const uint8_t SIMPLE_TRUE = 0xF5;
+  static const uint8_t NULL_VALUE = 0xF6;
+  static const uint8_t FLOAT32 = 0xFA;
+
+  CborWriter(uint8_t *buffer, size_t size) : buffer_(buffer), size_(size) {}
+
+  void begin() { this->put_(INDEFINITE_MAP); }
+  void add_time(int64_t epoch_ms) {
+    if (epoch_ms > 0)
+      this->add_uint("time", epoch_ms);
+  }
+  void add_float(const char *key, float value, uint8_t) {
+    this->key_(key);
+    if (std::isnan(value)) {
+      this->put_(NULL_VALUE);
+      return;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    this->put_(FLOAT32);
+    this->put_be_(bits, 4);
+  }
+  void add_uint(const char *key, uint64_t value) {
+    this->key_(key);
+    this->head_(MAJOR_UNSIGNED, value);
+  }
+  void add_bool(const char *key, bool value) {
+    this->key_(key);
+    this->put_(value ? SIMPLE_TRUE : SIMPLE_FALSE);
+  }
+  size_t end() {
+    this->put_(BREAK);
+    return this->overflow_ ? 0 : this->length_;
+  }
+
+ protected:
+  void key_(const char *key) {
+    size_t length = strlen(key);
+    this->head_(MAJOR_TEXT, length);
+    for (size_t i = 0; i < length; i++)
+      this->put_(key[i]);
+  }
+  // Initial byte with the shortest argument encoding
+  void head_(uint8_t major, uint64_t argument) {
+    uint8_t type = major << 5;
+    if (argument < 24) {
+      this->put_(type | argument);
+    } else if (argument <= UINT8_MAX) {
+      this->put_(type | 24);
+      this->put_be_(argument, 1);
+    } else if (argument <= UINT16_MAX) {
+      this->put_(type | 25);
+      this->put_be_(argument, 2);
+    } else if (argument <= UINT32_MAX) {
+      this->put_(type | 26);
+      this->put_be_(argument, 4);
+    } else {
+      this->put_(type | 27);
+      this->put_be_(argument, 8);
+    }
+  }
+  void put_be_(uint64_t value, uint8_t bytes) {
+    while (bytes-- > 0)
+      this->put_(value >> (8 * bytes));
+  }
+  void put_(uint8_t value) {
+    if (this->length_ >= this->size_) {
+      this->overflow_ = true;
+      return;
+    }
+    this->buffer_[this->length_++] = value;
+  }
+
+  uint8_t *buffer_;
+  size_t size_;
+  size_t length_{0};
+  bool overflow_{false};
+};
+
+// Decimals match the resolution of the station
+template<typename Writer>
+size_t write_frame(Writer &writer, const DecodedFrame &frame, float precipitation_intensity) {
+  writer.begin();
+  writer.add_time(frame.epoch_ms);
+  writer.add_float("temperature", frame.get_temperature(), 1);
+  writer.add_float("humidity", frame.get_humidity(), 0);
+  writer.add_float("pressure", frame.get_pressure(), 2);
+  writer.add_float("wind_speed", frame.get_wind_speed(), 2);
+  writer.add_float("wind_gust", frame.get_wind_gust(), 2);
+  writer.add_float("wind_direction", frame.get_wind_direction(), 0);
+  writer.add_float("accumulated_precipitation", frame.get_accumulated_precipitation(), 1);
+  writer.add_float("precipitation_intensity", precipitation_intensity, 1);
+  writer.add_float("uv_intensity", frame.get_uv_intensity(), 1);
+  writer.add_float("uv_index", frame.get_uv_index(), 0);
+  writer.add_float("light", frame.get_light(), 1);
+  writer.add_bool("low_battery", frame.low_battery);
+  writer.add_uint("quality", frame.quality);
+  return writer.end();
+}
+
+}  // namespace
+
+size_t serialize_frame(FrameFormat format, const DecodedFrame &frame, float precipitation_intensity, uint8_t *buffer,
+                       size_t size, const char *prefix) {
+  switch (format) {
+    case FrameFormat::CBOR: {
+      CborWriter writer(buffer, size);
+      return write_frame(writer, frame, precipitation_intensity);
+    }
+    case FrameFormat::LINE_PROTOCOL: {
+      LineProtocolWriter writer(buffer, size, prefix);
+      return write_frame(writer, frame, precipitation_intensity);
+    }
+    case FrameFormat::PROMETHEUS: {
+      PrometheusWriter writer(buffer, size, prefix);
+      return write_frame(writer, frame, precipitation_intensity);
+    }
+    default: {
+      JsonWriter writer(buffer, size);
+      return write_frame(writer, frame, precipitation_intensity);
+    }
+  }
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "decoded_frame.h"
+
+namespace esphome {
+namespace misol_weather {
+
+enum class FrameFormat : uint8_t {
+  JSON = 0,
+  CBOR,
+  LINE_PROTOCOL,
+  PROMETHEUS,
+};
+
+// Enough for every field of a frame with pressure as JSON, CBOR or line protocol with a prefix of up to 231 characters,
+// the config validation checks the prefix against it
+static const size_t MAX_FRAME_MESSAGE_SIZE = 512;
+// Prometheus repeats the metric names in the type lines
+static const size_t MAX_FRAME_METRICS_SIZE = 1536;
+
+// Writes the frame in physical units together with values derived from more than one frame as a single
+// map: null (or a missing "time") for values that are not available, "quality" is DecodedFrame::quality.
+// prefix is the measurement and tags of the line protocol and the metric name prefix of Prometheus.
+// Returns the message length, 0 when the buffer is too small.
+size_t serialize_frame(FrameFormat format, const DecodedFrame &frame, float precipitation_intensity, uint8_t *buffer,
+                       size_t size, const char *prefix = "");
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,65 @@
+#include "history_handler.h"
+#ifdef USE_MISOL_WEATHER_HISTORY
+#include <memory>
+#include <vector>
+
+namespace esphome {
+namespace misol_weather {
+
+// Small row groups keep the encoder buffers at a few hundred bytes
+static const uint16_t HISTORY_ROWS_PER_GROUP = 16;
+
+namespace {
+
+class BufferSink : public ColumnSink {
+ public:
+  explicit BufferSink(std::vector<uint8_t> &buffer) : buffer_(buffer) {}
+  void write(const uint8_t *data, size_t length) override {
+    this->buffer_.insert(this->buffer_.end(), data, data + length);
+  }
+
+ protected:
+  std::vector<uint8_t> &buffer_;
+};
+
+}  // namespace
+
+void HistoryHandler::handleRequest(AsyncWebServerRequest *request) {
+  // Response streams of the ESP-IDF web server only take text, the file is built in memory. Its size is bounded
+  // by the flight recorder, about 11 kB for 255 frames.
+  auto response = std::make_shared<std::vector<uint8_t>>();
+  BufferSink sink(*response);
+  auto encoder = std::make_unique<ColumnEncoder>(&sink, HISTORY_ROWS_PER_GROUP);
+  uint8_t uptime_column = encoder->add_column("uptime_ms", ColumnType::UINT32, false);
+  uint8_t time_column = encoder->add_column("time_ms", ColumnType::UINT64, true);
+  FrameColumnSchema schema;
+  schema.add_to(*encoder);
+  // The main loop records frames and synchronizes the wall clock under the lock, encoding 255 frames takes it only
+  // for a few milliseconds
+  {
+    LockGuard lock(this->parent_->get_state_lock());
+    const FlightRecorder &recorder = this->parent_->get_flight_recorder();
+    const WallClock &wall_clock = this->parent_->get_wall_clock();
+    for (uint8_t i = 0; i < recorder.size(); i++) {
+      const RecordedFrame &recorded = recorder.get(i);
+      encoder->set(uptime_column, recorded.timestamp_ms);
+      int64_t epoch_ms = wall_clock.to_epoch_ms(recorded.timestamp_ms);
+      if (epoch_ms > 0)
+        encoder->set(time_column, epoch_ms);
+      // Filtered values with the quality flags of the outlier filter, staleness and the fault detectors
+      schema.set(*encoder, recorded.result, recorder.get_processed(i));
+      encoder->end_row();
+    }
+  }
+  encoder->finish();
+  request->send(request->beginResponse_P(200, "application/octet-stream", response->data(), response->size()));
+#ifndef USE_ESP32
+  // ESPAsyncWebServer sends the response after handleRequest() returns, the buffer is freed with the request. The
+  // ESP-IDF web server of the ESP32 sends it before send() returns.
+  request->onDisconnect([response]() {});
+#endif
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_MISOL_WEATHER_HISTORY
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_MISOL_WEATHER_HISTORY
+#include <string>
+#include "esphome/core/component.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "column_encoder.h"
+#include "weather_station.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Serves the frames of the flight recorder, decoded, as a column file (see ColumnEncoder)
+class HistoryHandler : public AsyncWebHandler, public Component {
+ public:
+  HistoryHandler(web_server_base::WebServerBase *base, WeatherStation *parent, const std::string &path)
+      : base_(base), parent_(parent), path_(path) {}
+
+  bool canHandle(AsyncWebServerRequest *request) const override {
+    return (request->method() == HTTP_GET) && (request->url() == this->path_.c_str());
+  }
+  void handleRequest(AsyncWebServerRequest *request) override;
+  void setup() override {
+    this->base_->init();
+    this->base_->add_handler(this);
+  }
+  float get_setup_priority() const override { return setup_priority::WIFI - 1.0f; }
+
+ protected:
+  web_server_base::WebServerBase *base_;
+  WeatherStation *parent_;
+  std::string path_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_MISOL_WEATHER_HISTORY
@@ -0,0 +1,133 @@
+#include "weather_station.h"
+
+#ifdef USE_MISOL_WEATHER_DMA
+#include <cstring>
+#include <hardware/dma.h>
+#include <hardware/sync.h>
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/uart/uart_component_rp2040.h"
+
+namespace esphome {
+namespace misol_weather {
+
+static const char *const TAG = "misol_weather";
+
+// At 9600 baud about 2 bytes arrive between two timer calls, far below the ring size
+static const int32_t DMA_TIMER_INTERVAL_MS = 2;
+// Idle line time that ends a frame, about 10 characters
+static const uint32_t DMA_IDLE_GAP_US = 10000;
+static const uint32_t DMA_TRANSFER_COUNT = 0xFFFFFFFF;
+
+bool WeatherStation::start_dma_() {
+  auto *uart = static_cast<uart::RP2040UartComponent *>(this->parent_);
+  if (!uart->is_hw_serial()) {
+    ESP_LOGE(TAG, "UART DMA needs a hardware UART, the UART pins are served by PIO");
+    return false;
+  }
+  uart_inst_t *hw_uart = uart->get_hw_serial_number() == 0 ? uart0 : uart1;
+  int channel = dma_claim_unused_channel(false);
+  if (channel < 0) {
+    ESP_LOGE(TAG, "No free DMA channel");
+    return false;
+  }
+  if (!add_repeating_timer_ms(-DMA_TIMER_INTERVAL_MS, WeatherStation::dma_timer_callback_, this,
+                              &this->dma_timer_)) {
+    ESP_LOGE(TAG, "No free timer for the idle line detection");
+    dma_channel_unclaim(channel);
+    return false;
+  }
+  // The serial driver reads the FIFO from its interrupt, the DMA channel takes over
+  uart_set_irq_enables(hw_uart, false, false);
+  hw_set_bits(&uart_get_hw(hw_uart)->dmacr, UART_UARTDMACR_RXDMAE_BITS);
+  this->dma_ring_storage_ = std::make_unique<uint8_t[]>(2 * DMA_RING_SIZE);
+  uintptr_t storage = (uintptr_t) this->dma_ring_storage_.get();
+  this->dma_ring_ = this->dma_ring_storage_.get() + ((DMA_RING_SIZE - storage % DMA_RING_SIZE) % DMA_RING_SIZE);
+  dma_channel_config config = dma_channel_get_default_config(channel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+  channel_config_set_read_increment(&config, false);
+  channel_config_set_write_increment(&config, true);
+  channel_config_set_ring(&config, true, DMA_RING_BITS);
+  channel_config_set_dreq(&config, uart_get_dreq(hw_uart, false));
+  dma_channel_configure(channel, &config, this->dma_ring_, &uart_get_hw(hw_uart)->dr, DMA_TRANSFER_COUNT, true);
+  this->dma_channel_ = channel;
+  return true;
+}
+
+// Runs in the timer interrupt: tracks the received bytes from the DMA write address and marks
+// the end of a frame once the line has been idle long enough.
+bool WeatherStation::dma_timer_callback_(repeating_timer_t *timer) {
+  WeatherStation *station = static_cast<WeatherStation *>(timer->user_data);
+  if (station->dma_channel_ < 0)
+    return true;
+  dma_channel_hw_t *channel = dma_channel_hw_addr(station->dma_channel_);
+  uint32_t now_us = time_us_32();
+  uint32_t position = (channel->write_addr - (uint32_t) (uintptr_t) station->dma_ring_) & (DMA_RING_SIZE - 1);
+  uint32_t received = (position - station->dma_position_) & (DMA_RING_SIZE - 1);
+  if (received > 0) {
+    station->dma_position_ = position;
+    station->dma_received_ = station->dma_received_ + received;
+    station->dma_last_byte_us_ = now_us;
+  } else if ((station->dma_frame_end_ != station->dma_received_) &&
+             (now_us - station->dma_last_byte_us_ >= DMA_IDLE_GAP_US)) {
+    station->dma_frame_end_us_ = station->dma_last_byte_us_;
+    station->dma_frame_end_ = station->dma_received_;
+  }
+  // The transfer count runs out after about 50 days, the UART FIFO holds the bytes until the restart
+  if (!dma_channel_is_busy(station->dma_channel_))
+    dma_channel_set_trans_count(station->dma_channel_, DMA_TRANSFER_COUNT, true);
+  return true;
+}
+
+void WeatherStation::process_dma_ring_(const std::chrono::steady_clock::time_point &now) {
+  uint32_t interrupts = save_and_disable_interrupts();
+  uint32_t received = this->dma_received_;
+  uint32_t frame_end = this->dma_frame_end_;
+  uint32_t frame_end_us = this->dma_frame_end_us_;
+  restore_interrupts(interrupts);
+  uint32_t pending = received - this->dma_read_;
+  if (pending > DMA_RING_SIZE) {
+    ESP_LOGW(TAG, "DMA ring overrun, %u bytes lost", (unsigned) (pending - DMA_RING_SIZE));
+    bool in_sync = true;
+    this->discard_rx_bytes_(pending - DMA_RING_SIZE, in_sync);
+    this->dma_read_ = received - DMA_RING_SIZE;
+  }
+  if (pending > 0)
+    this->last_packet_time_ = now;
+  if (frame_end != this->dma_handled_frame_end_) {
+    // The frame end can be behind the bytes already copied when the idle gap is seen after the copy
+    if (frame_end - this->dma_read_ <= received - this->dma_read_)
+      this->copy_dma_data_(frame_end, now);
+    this->dma_handled_frame_end_ = frame_end;
+    if (this->rx_length_ > 0) {
+      ESP_LOGV(TAG, "%s received: %s", this->first_data_received_ ? "Packet" : "First packet",
+               format_hex_pretty(this->rx_buffer_, this->rx_length_).c_str());
+      this->first_data_received_ = true;
+      // The timer interrupt saw the last byte of the frame within its interval
+      this->update_rx_start_time_(now - std::chrono::microseconds(time_us_32() - frame_end_us), 0);
+      this->parse_rx_buffer_(true);
+    }
+  }
+  this->copy_dma_data_(received, now);
+}
+
+void WeatherStation::copy_dma_data_(uint32_t until, const std::chrono::steady_clock::time_point &now) {
+  while (this->dma_read_ != until) {
+    if (this->rx_length_ == RX_BUFFER_SIZE) {
+      // Buffer is full without an idle gap, extract complete frames to make room
+      this->parse_rx_buffer_(false);
+    }
+    uint32_t offset = this->dma_read_ & (DMA_RING_SIZE - 1);
+    size_t chunk = std::min<size_t>(until - this->dma_read_, DMA_RING_SIZE - offset);
+    chunk = std::min(chunk, RX_BUFFER_SIZE - this->rx_length_);
+    memcpy(this->rx_buffer_ + this->rx_length_, this->dma_ring_ + offset, chunk);
+    this->rx_length_ += chunk;
+    this->dma_read_ += chunk;
+    this->update_rx_start_time_(now, chunk);
+  }
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+
+#endif  // USE_MISOL_WEATHER_DMA
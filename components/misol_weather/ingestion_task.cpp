@@ -0,0 +1,66 @@
+#include "weather_station.h"
+
+#ifdef USE_MISOL_WEATHER_TASK
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace misol_weather {
+
+static const char *const TAG = "misol_weather";
+
+static const uint32_t RX_TASK_STACK_SIZE = 4096;
+// Above the main loop task, below the Wi-Fi and lwIP tasks
+static const UBaseType_t RX_TASK_PRIORITY = 5;
+// The UART driver buffers the bytes in between, a frame takes about 22 ms to receive
+static const uint32_t RX_TASK_POLL_INTERVAL_MS = 10;
+#if CONFIG_FREERTOS_UNICORE
+static const BaseType_t RX_TASK_CORE = tskNO_AFFINITY;
+#else
+// Wi-Fi and the network stack run on the protocol core
+static const BaseType_t RX_TASK_CORE = 1;
+#endif
+
+bool WeatherStation::start_rx_task_() {
+  BaseType_t result = xTaskCreatePinnedToCore(WeatherStation::rx_task_, "misol_rx", RX_TASK_STACK_SIZE, this,
+                                              RX_TASK_PRIORITY, &this->rx_task_handle_, RX_TASK_CORE);
+  if (result != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create the receive task");
+    this->rx_task_handle_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// Reads and validates frames. Besides the UART it touches the receive buffer, which only this task uses, the
+// producer side of the frame queue and the atomic counters of discarded bytes. Checks are not profiled here.
+void WeatherStation::rx_task_(void *arg) {
+  WeatherStation *station = static_cast<WeatherStation *>(arg);
+  std::chrono::steady_clock::time_point last_read_time;
+  while (true) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    int size = station->available();
+    if (size > 0) {
+      station->read_rx_data_(size, now);
+      last_read_time = now;
+    } else if ((station->rx_length_ > 0) && (now - last_read_time > FRAME_IDLE_GAP)) {
+      station->parse_rx_buffer_(true);
+    }
+    vTaskDelay(pdMS_TO_TICKS(RX_TASK_POLL_INTERVAL_MS));
+  }
+}
+
+void WeatherStation::process_frame_queue_() {
+  this->link_statistics_.resyncs += this->task_resyncs_.exchange(0, std::memory_order_relaxed);
+  this->link_statistics_.bytes_discarded += this->task_bytes_discarded_.exchange(0, std::memory_order_relaxed);
+  FrameRecord record;
+  while (this->frame_queue_.pop(record)) {
+    this->first_data_received_ = true;
+    this->last_packet_time_ = record.timestamp;
+    this->handle_frame_(record.data, record.length, record.result, record.timestamp);
+  }
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+
+#endif  // USE_MISOL_WEATHER_TASK
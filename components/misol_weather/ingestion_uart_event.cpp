@@ -0,0 +1,81 @@
+#include "weather_station.h"
+
+#ifdef USE_MISOL_WEATHER_UART_EVENT
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/components/uart/uart_component_esp_idf.h"
+
+namespace esphome {
+namespace misol_weather {
+
+static const char *const TAG = "misol_weather";
+
+// Idle time in characters that ends a frame, frames are sent without gaps between bytes
+static const uint8_t RX_TIMEOUT_CHARACTERS = 10;
+
+// The UART component installs its driver with an event queue and keeps the handle protected, a derived class can
+// form a pointer to the member to read it
+class UARTEventQueueAccess : public uart::IDFUARTComponent {
+ public:
+  static QueueHandle_t get(uart::IDFUARTComponent *uart) { return uart->*(&UARTEventQueueAccess::uart_event_queue_); }
+};
+
+bool WeatherStation::setup_uart_events_() {
+  auto *uart = static_cast<uart::IDFUARTComponent *>(this->parent_);
+  this->uart_port_ = (uart_port_t) uart->get_hw_serial_number();
+  // The driver stays as the UART component installed it, only the RX timeout changes
+  QueueHandle_t queue = UARTEventQueueAccess::get(uart);
+  if (queue == nullptr) {
+    ESP_LOGE(TAG, "The UART driver has no event queue");
+    return false;
+  }
+  esp_err_t err = uart_set_rx_timeout(this->uart_port_, RX_TIMEOUT_CHARACTERS);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to set the UART RX timeout: %s", esp_err_to_name(err));
+    return false;
+  }
+  this->uart_event_queue_ = queue;
+  return true;
+}
+
+void WeatherStation::process_uart_events_(const std::chrono::steady_clock::time_point &now) {
+  uart_event_t event;
+  while (xQueueReceive(this->uart_event_queue_, &event, 0) == pdTRUE) {
+    switch (event.type) {
+      case UART_DATA:
+        if (event.size > 0) {
+          this->read_rx_data_(event.size, now);
+          this->last_packet_time_ = now;
+        }
+        if (event.timeout_flag && (this->rx_length_ > 0)) {
+          // The line has been idle for the RX timeout, the last byte arrived that long ago
+          this->update_rx_start_time_(now - this->character_time_ * RX_TIMEOUT_CHARACTERS, 0);
+          ESP_LOGV(TAG, "%s received: %s", this->first_data_received_ ? "Packet" : "First packet",
+                   format_hex_pretty(this->rx_buffer_, this->rx_length_).c_str());
+          this->first_data_received_ = true;
+          this->parse_rx_buffer_(true);
+        }
+        break;
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL: {
+        ESP_LOGW(TAG, "UART receive overflow, dropping received data");
+        size_t buffered = 0;
+        uart_get_buffered_data_len(this->uart_port_, &buffered);
+        uart_flush_input(this->uart_port_);
+        xQueueReset(this->uart_event_queue_);
+        size_t dropped = this->rx_length_ + buffered;
+        if (dropped > 0)
+          this->discard_rx_bytes_(dropped, true);
+        this->rx_length_ = 0;
+        return;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+
+#endif  // USE_MISOL_WEATHER_UART_EVENT
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Precipitation intensity from the rain gauge counter over fixed windows. With the wall clock known the windows
+// end on its boundaries, e.g. :00 and :05, with the first frame after the boundary, otherwise with the first frame
+// more than the interval after the start of the window. A partial first window on the wall clock, after boot or
+// after the clock was set, that is shorter than half the interval is dropped.
+class IntensityWindow {
+ public:
+  explicit IntensityWindow(uint32_t interval_ms) : interval_ms_(interval_ms) {}
+
+  void set_interval(uint32_t interval_ms) { this->interval_ms_ = interval_ms; }
+  uint32_t get_interval() const { return this->interval_ms_; }
+  // Starts again with the next counter, the intensity is unknown until a window ends
+  void reset() {
+    this->has_start_ = false;
+    this->intensity_ = NAN;
+  }
+
+  // epoch_ms is 0 when the wall clock is unknown. Returns true when a window ended and the intensity is updated.
+  bool update(uint16_t counter, uint32_t timestamp_ms, int64_t epoch_ms) {
+    if (!this->has_start_) {
+      this->start_(counter, timestamp_ms);
+      return false;
+    }
+    uint32_t elapsed_ms = timestamp_ms - this->start_ms_;
+    bool window_ended = elapsed_ms > this->interval_ms_;
+    if (epoch_ms != 0) {
+      int64_t start_epoch_ms = epoch_ms - elapsed_ms;
+      window_ended = (epoch_ms / this->interval_ms_) != (start_epoch_ms / this->interval_ms_);
+      if (window_ended && (elapsed_ms < this->interval_ms_ / 2)) {
+        // Partial first window, too short for a rate
+        this->start_(counter, timestamp_ms);
+        return false;
+      }
+    }
+    if (!window_ended || (elapsed_ms == 0))
+      return false;
+    // The tip counter wraps at 16 bits, 0.3 mm per tip
+    uint16_t ticks = counter - this->start_counter_;
+    this->intensity_ = ticks * 0.3f * 3600000.0f / elapsed_ms;
+    this->start_(counter, timestamp_ms);
+    return true;
+  }
+  // mm/h, NAN before the first window ended
+  float get_intensity() const { return this->intensity_; }
+
+ protected:
+  void start_(uint16_t counter, uint32_t timestamp_ms) {
+    this->start_counter_ = counter;
+    this->start_ms_ = timestamp_ms;
+    this->has_start_ = true;
+  }
+
+  uint32_t interval_ms_;
+  bool has_start_{false};
+  uint16_t start_counter_{0};
+  uint32_t start_ms_{0};
+  float intensity_{NAN};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/defines.h"
+
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+#if defined(USE_ESP32)
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif defined(USE_ESP8266)
+#include <Esp.h>
+#elif defined(USE_RP2040)
+#include <Arduino.h>
+#endif
+
+namespace esphome {
+namespace misol_weather {
+
+// Value used when the platform does not provide the measurement
+static const uint32_t MEMORY_NOT_AVAILABLE = UINT32_MAX;
+
+struct MemorySnapshot {
+  uint32_t free_heap{MEMORY_NOT_AVAILABLE};
+  uint32_t largest_free_block{MEMORY_NOT_AVAILABLE};
+  uint32_t stack_headroom{MEMORY_NOT_AVAILABLE};
+
+  static MemorySnapshot take() {
+    MemorySnapshot snapshot;
+#if defined(USE_ESP32)
+    snapshot.free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    snapshot.largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    snapshot.stack_headroom = uxTaskGetStackHighWaterMark(nullptr);
+#elif defined(USE_ESP8266)
+    snapshot.free_heap = ESP.getFreeHeap();
+    snapshot.largest_free_block = ESP.getMaxFreeBlockSize();
+    snapshot.stack_headroom = ESP.getFreeContStack();
+#elif defined(USE_RP2040)
+    snapshot.free_heap = rp2040.getFreeHeap();
+#endif
+    return snapshot;
+  }
+};
+
+// Lowest values seen so far
+struct MemoryWatermarks {
+  uint32_t min_free_heap{MEMORY_NOT_AVAILABLE};
+  uint32_t min_largest_free_block{MEMORY_NOT_AVAILABLE};
+  uint32_t min_stack_headroom{MEMORY_NOT_AVAILABLE};
+
+  void update(const MemorySnapshot &snapshot) {
+    if (snapshot.free_heap < this->min_free_heap)
+      this->min_free_heap = snapshot.free_heap;
+    if (snapshot.largest_free_block < this->min_largest_free_block)
+      this->min_largest_free_block = snapshot.largest_free_block;
+    if (snapshot.stack_headroom < this->min_stack_headroom)
+      this->min_stack_headroom = snapshot.stack_headroom;
+  }
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+
+#endif  // USE_MISOL_WEATHER_MEMORY_WATERMARKS
@@ -0,0 +1,68 @@
+#include "metrics_handler.h"
+#ifdef USE_MISOL_WEATHER_METRICS
+#include <chrono>
+#include <cmath>
+
+namespace esphome {
+namespace misol_weather {
+
+static const char *const METRIC_PREFIX = "misol_weather_";
+
+void MetricsHandler::handleRequest(AsyncWebServerRequest *request) {
+  // Snapshot of the state the main loop changes, the response is built without the lock
+  DecodedFrame frame;
+  bool has_frame;
+  float precipitation_intensity;
+  LinkStatistics link;
+  uint32_t missed_transmissions;
+  float link_quality;
+  float jitter;
+  {
+    LockGuard lock(this->parent_->get_state_lock());
+    has_frame = this->parent_->get_last_frame(frame);
+    precipitation_intensity = this->parent_->get_precipitation_intensity();
+    link = this->parent_->get_link_statistics();
+    const CadenceTracker &cadence = this->parent_->get_cadence_tracker();
+    missed_transmissions = cadence.get_missed_transmissions();
+    uint32_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+    link_quality = cadence.get_link_quality(now_ms);
+    jitter = cadence.get_jitter_ms();
+  }
+
+  AsyncResponseStream *stream = request->beginResponseStream("text/plain; version=0.0.4; charset=utf-8");
+  if (has_frame) {
+    size_t length = serialize_frame(FrameFormat::PROMETHEUS, frame, precipitation_intensity, this->buffer_,
+                                    sizeof(this->buffer_) - 1, METRIC_PREFIX);
+    this->buffer_[length] = '\0';
+    stream->print(reinterpret_cast<const char *>(this->buffer_));
+  }
+  const struct {
+    const char *name;
+    uint32_t value;
+  } counters[] = {
+      {"frames_ok_total", link.frames_ok},
+      {"checksum_failures_total", link.checksum_failures},
+      {"pressure_failures_total", link.pressure_failures},
+      {"resyncs_total", link.resyncs},
+      {"bytes_discarded_total", link.bytes_discarded},
+      {"missed_transmissions_total", missed_transmissions},
+  };
+  for (const auto &counter : counters) {
+    stream->printf("# TYPE %s%s counter\n%s%s %u\n", METRIC_PREFIX, counter.name, METRIC_PREFIX, counter.name,
+                   (unsigned) counter.value);
+  }
+  if (!std::isnan(link_quality)) {
+    stream->printf("# TYPE %slink_quality gauge\n%slink_quality %.1f\n", METRIC_PREFIX, METRIC_PREFIX, link_quality);
+  }
+  if (!std::isnan(jitter)) {
+    stream->printf("# TYPE %sinter_arrival_jitter_seconds gauge\n%sinter_arrival_jitter_seconds %.3f\n",
+                   METRIC_PREFIX, METRIC_PREFIX, jitter / 1000.0f);
+  }
+  request->send(stream);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_MISOL_WEATHER_METRICS
@@ -0,0 +1,77 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import number
+from esphome.const import (
+    ENTITY_CATEGORY_CONFIG,
+    ICON_SIGN_DIRECTION,
+    UNIT_DEGREES,
+    UNIT_MINUTE,
+)
+from . import (
+    CONF_MISOL_ID,
+    WeatherStation,
+    misol_ns,
+)
+
+CODEOWNERS = ["@paveldn"]
+
+CONF_LOWER_NIGHT_THRESHOLD = "lower_night_threshold"
+CONF_NORTH_CORRECTION = "north_correction"
+CONF_PRECIPITATION_INTENSITY_INTERVAL = "precipitation_intensity_interval"
+CONF_UPPER_NIGHT_THRESHOLD = "upper_night_threshold"
+ICON_TIMER_COG = "mdi:timer-cog-outline"
+ICON_WEATHER_NIGHT = "mdi:weather-night"
+UNIT_ULTRAVIOLET_INTENSITY = "mW/m²"
+
+SettingNumber = misol_ns.class_(
+    "SettingNumber", number.Number, cg.Component, cg.Parented.template(WeatherStation)
+)
+Setting = misol_ns.enum("Setting")
+
+# Setting, min, max, step
+SETTINGS = {
+    CONF_UPPER_NIGHT_THRESHOLD: (Setting.SETTING_UPPER_NIGHT_THRESHOLD, 0.0, 100.0, 0.1),
+    CONF_LOWER_NIGHT_THRESHOLD: (Setting.SETTING_LOWER_NIGHT_THRESHOLD, 0.0, 100.0, 0.1),
+    CONF_NORTH_CORRECTION: (Setting.SETTING_NORTH_CORRECTION, -180.0, 180.0, 1.0),
+    CONF_PRECIPITATION_INTENSITY_INTERVAL: (Setting.SETTING_PRECIPITATION_INTENSITY_INTERVAL, 1.0, 60.0, 1.0),
+}
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_MISOL_ID): cv.use_id(WeatherStation),
+        cv.Optional(CONF_UPPER_NIGHT_THRESHOLD): number.number_schema(
+            SettingNumber,
+            icon=ICON_WEATHER_NIGHT,
+            unit_of_measurement=UNIT_ULTRAVIOLET_INTENSITY,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend(cv.COMPONENT_SCHEMA),
+        cv.Optional(CONF_LOWER_NIGHT_THRESHOLD): number.number_schema(
+            SettingNumber,
+            icon=ICON_WEATHER_NIGHT,
+            unit_of_measurement=UNIT_ULTRAVIOLET_INTENSITY,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend(cv.COMPONENT_SCHEMA),
+        cv.Optional(CONF_NORTH_CORRECTION): number.number_schema(
+            SettingNumber,
+            icon=ICON_SIGN_DIRECTION,
+            unit_of_measurement=UNIT_DEGREES,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend(cv.COMPONENT_SCHEMA),
+        cv.Optional(CONF_PRECIPITATION_INTENSITY_INTERVAL): number.number_schema(
+            SettingNumber,
+            icon=ICON_TIMER_COG,
+            unit_of_measurement=UNIT_MINUTE,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend(cv.COMPONENT_SCHEMA),
+    }
+)
+
+
+async def to_code(config):
+    paren = await cg.get_variable(config[CONF_MISOL_ID])
+
+    for key, (setting, min_value, max_value, step) in SETTINGS.items():
+        if conf := config.get(key):
+            num = await number.new_number(conf, setting, min_value=min_value, max_value=max_value, step=step)
+            await cg.register_component(num, conf)
+            await cg.register_parented(num, paren)
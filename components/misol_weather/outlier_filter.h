@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace esphome {
+namespace misol_weather {
+
+enum class OutlierFilterMethod : uint8_t {
+  HAMPEL = 0,
+  MEDIAN,
+};
+
+// Robust filter over a fixed window of raw integer samples.
+// Hampel replaces samples deviating from the window median by more than threshold * MAD,
+// median of N always outputs the window median.
+template<typename T> class OutlierFilter {
+ public:
+  static const uint8_t MAX_WINDOW_SIZE = 15;
+  // Filtering starts when the window holds at least this number of samples
+  static const uint8_t MIN_SAMPLES = 3;
+
+  void configure(OutlierFilterMethod method, uint8_t window_size, float threshold, T min_deviation) {
+    this->method_ = method;
+    this->window_size_ = window_size < MAX_WINDOW_SIZE ? window_size : MAX_WINDOW_SIZE;
+    this->threshold_ = threshold;
+    this->min_deviation_ = min_deviation;
+    this->count_ = 0;
+    this->next_ = 0;
+  }
+
+  // Returns the filtered value, rejected is set when the sample is considered an outlier
+  T apply(T value, bool &rejected) {
+    rejected = false;
+    this->window_[this->next_] = value;
+    this->next_ = (this->next_ + 1) % this->window_size_;
+    if (this->count_ < this->window_size_)
+      this->count_++;
+    if (this->count_ < MIN_SAMPLES)
+      return value;
+    T sorted[MAX_WINDOW_SIZE];
+    for (uint8_t i = 0; i < this->count_; i++)
+      sorted[i] = this->window_[i];
+    sort_(sorted, this->count_);
+    T median = sorted[this->count_ / 2];
+    uint32_t deviation = distance_(value, median);
+    if (this->method_ == OutlierFilterMethod::MEDIAN) {
+      rejected = deviation > this->min_deviation_;
+      return median;
+    }
+    for (uint8_t i = 0; i < this->count_; i++)
+      sorted[i] = distance_(this->window_[i], median);
+    sort_(sorted, this->count_);
+    float limit = this->threshold_ * 1.4826f * sorted[this->count_ / 2];
+    if (limit < this->min_deviation_)
+      limit = this->min_deviation_;
+    if (deviation > limit) {
+      rejected = true;
+      return median;
+    }
+    return value;
+  }
+
+ protected:
+  static uint32_t distance_(T a, T b) { return a > b ? a - b : b - a; }
+  static void sort_(T *values, uint8_t count) {
+    for (uint8_t i = 1; i < count; i++) {
+      T value = values[i];
+      uint8_t j = i;
+      for (; (j > 0) && (values[j - 1] > value); j--)
+        values[j] = values[j - 1];
+      values[j] = value;
+    }
+  }
+
+  T window_[MAX_WINDOW_SIZE]{};
+  OutlierFilterMethod method_{OutlierFilterMethod::HAMPEL};
+  uint8_t window_size_{MAX_WINDOW_SIZE};
+  uint8_t count_{0};
+  uint8_t next_{0};
+  float threshold_{3.0f};
+  T min_deviation_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/defines.h"
+
+#ifdef USE_MISOL_WEATHER_PROFILING
+#if defined(USE_ESP_IDF)
+#include <esp_cpu.h>
+#include <esp_rom_sys.h>
+#elif defined(USE_ARDUINO)
+#include <Arduino.h>
+#elif defined(USE_HOST)
+#include <chrono>
+#endif
+
+namespace esphome {
+namespace misol_weather {
+
+enum ProfileSection : uint8_t {
+  PROFILE_LOOP = 0,
+  PROFILE_CHECK_PACKET,
+  PROFILE_PROCESS_PACKET,
+  PROFILE_PUBLISH,
+  PROFILE_SECTION_COUNT,
+};
+
+enum ProfileStatistic : uint8_t {
+  PROFILE_P50 = 0,
+  PROFILE_P99,
+  PROFILE_MAX,
+  PROFILE_STATISTIC_COUNT,
+};
+
+// CPU cycles on ESP32, ESP8266 and RP2040, nanoseconds on host
+inline uint32_t get_profiler_ticks() {
+#if defined(USE_ESP_IDF)
+  return esp_cpu_get_cycle_count();
+#elif defined(USE_ARDUINO) && (defined(USE_ESP32) || defined(USE_ESP8266))
+  return ESP.getCycleCount();
+#elif defined(USE_ARDUINO) && defined(USE_RP2040)
+  return rp2040.getCycleCount();
+#elif defined(USE_HOST)
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#else
+  return micros();
+#endif
+}
+
+inline float get_profiler_ticks_per_us() {
+#if defined(USE_ESP_IDF)
+  return esp_rom_get_cpu_ticks_per_us();
+#elif defined(USE_ARDUINO) && (defined(USE_ESP32) || defined(USE_ESP8266))
+  return ESP.getCpuFreqMHz();
+#elif defined(USE_ARDUINO) && defined(USE_RP2040)
+  return rp2040.f_cpu() / 1000000.0f;
+#elif defined(USE_HOST)
+  return 1000.0f;
+#else
+  return 1.0f;
+#endif
+}
+
+// Fixed size histogram with power of two buckets: bucket N counts durations in [2^(N-1), 2^N) ticks
+class LatencyHistogram {
+ public:
+  static const uint8_t BUCKET_COUNT = 32;
+
+  void add(uint32_t ticks) {
+    uint8_t bucket = (ticks == 0) ? 0 : 32 - __builtin_clz(ticks);
+    if (bucket >= BUCKET_COUNT)
+      bucket = BUCKET_COUNT - 1;
+    this->buckets_[bucket]++;
+    this->count_++;
+    if (ticks > this->max_)
+      this->max_ = ticks;
+  }
+  // Upper bound of the bucket containing the requested percentile
+  uint32_t get_percentile(uint8_t percent) const {
+    if (this->count_ == 0)
+      return 0;
+    uint32_t rank = (uint32_t) (((uint64_t) this->count_ * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+      seen += this->buckets_[i];
+      if (seen >= rank) {
+        uint32_t upper = (i == BUCKET_COUNT - 1) ? this->max_ : (1u << i) - 1;
+        return upper < this->max_ ? upper : this->max_;
+      }
+    }
+    return this->max_;
+  }
+  uint32_t get_bucket(uint8_t bucket) const { return this->buckets_[bucket]; }
+  uint32_t get_count() const { return this->count_; }
+  uint32_t get_max() const { return this->max_; }
+  void reset() { *this = LatencyHistogram(); }
+
+ protected:
+  uint32_t buckets_[BUCKET_COUNT]{};
+  uint32_t count_{0};
+  uint32_t max_{0};
+};
+
+class ProfileScope {
+ public:
+  explicit ProfileScope(LatencyHistogram &histogram) : histogram_(histogram), start_(get_profiler_ticks()) {}
+  ~ProfileScope() { this->histogram_.add(get_profiler_ticks() - this->start_); }
+
+ protected:
+  LatencyHistogram &histogram_;
+  uint32_t start_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+
+#endif  // USE_MISOL_WEATHER_PROFILING
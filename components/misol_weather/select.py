@@ -0,0 +1,42 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import select
+from esphome.const import (
+    ENTITY_CATEGORY_CONFIG,
+    ICON_SIGN_DIRECTION,
+)
+from . import (
+    CONF_MISOL_ID,
+    WeatherStation,
+    misol_ns,
+)
+
+CODEOWNERS = ["@paveldn"]
+
+CONF_COMPASS_POINTS = "compass_points"
+# Number of points of the wind direction text, parsed by CompassPointsSelect
+COMPASS_POINTS_OPTIONS = ["8", "16"]
+
+CompassPointsSelect = misol_ns.class_(
+    "CompassPointsSelect", select.Select, cg.Component, cg.Parented.template(WeatherStation)
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_MISOL_ID): cv.use_id(WeatherStation),
+        cv.Optional(CONF_COMPASS_POINTS): select.select_schema(
+            CompassPointsSelect,
+            icon=ICON_SIGN_DIRECTION,
+            entity_category=ENTITY_CATEGORY_CONFIG,
+        ).extend(cv.COMPONENT_SCHEMA),
+    }
+)
+
+
+async def to_code(config):
+    paren = await cg.get_variable(config[CONF_MISOL_ID])
+
+    if conf := config.get(CONF_COMPASS_POINTS):
+        sel = await select.new_select(conf, options=COMPASS_POINTS_OPTIONS)
+        await cg.register_component(sel, conf)
+        await cg.register_parented(sel, paren)
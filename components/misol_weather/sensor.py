@@ -1,9 +1,11 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import sensor
+from esphome.components import mqtt, sensor
 from esphome.const import (
     CONF_HUMIDITY,
+    CONF_MAX,
     CONF_LIGHT,
+    CONF_MQTT_ID,
     CONF_PRESSURE,
     CONF_TEMPERATURE,
     CONF_WIND_DIRECTION_DEGREES,
@@ -15,6 +17,8 @@ from esphome.const import (
     DEVICE_CLASS_PRECIPITATION_INTENSITY,
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_WIND_SPEED,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_COUNTER,
     ICON_SIGN_DIRECTION,
     ICON_WEATHER_WINDY,
     STATE_CLASS_MEASUREMENT,
@@ -24,24 +28,66 @@ from esphome.const import (
     UNIT_DEGREES,
     UNIT_HECTOPASCAL,
     UNIT_LUX,
+    UNIT_MILLISECOND,
     UNIT_PERCENT,
 )
 from . import (
     CONF_MISOL_ID,
     WeatherStation,
+    misol_ns,
 )
 
 CODEOWNERS = ["@paveldn"]
 
 CONF_ACCUMULATED_PRECIPITATION = "accumulated_precipitation"
+CONF_BATTERY_DAYS_TO_FAILURE = "battery_days_to_failure"
+CONF_BATTERY_LOW_RATIO = "battery_low_ratio"
+CONF_BYTES_DISCARDED = "bytes_discarded"
+CONF_CHECK_PACKET_TIME = "check_packet_time"
+CONF_CHECKSUM_FAILURES = "checksum_failures"
+CONF_CLOCK_DRIFT = "clock_drift"
+CONF_FRAMES_OK = "frames_ok"
+CONF_DEGRADED_FIELDS = "degraded_fields"
+CONF_FILTER_REJECTIONS = "filter_rejections"
+CONF_FRAMES_PER_HOUR = "frames_per_hour"
+CONF_INTER_ARRIVAL_JITTER = "inter_arrival_jitter"
+CONF_LINK_QUALITY = "link_quality"
+CONF_LOOP_TIME = "loop_time"
+CONF_MIN_FREE_HEAP = "min_free_heap"
+CONF_MIN_LARGEST_FREE_BLOCK = "min_largest_free_block"
+CONF_MIN_STACK_HEADROOM = "min_stack_headroom"
+CONF_MISSED_TRANSMISSIONS = "missed_transmissions"
+CONF_P50 = "p50"
+CONF_P99 = "p99"
 CONF_PRECIPITATION_INTENSITY = "precipitation_intensity"
+CONF_PRESSURE_FAILURES = "pressure_failures"
+CONF_PROCESS_PACKET_TIME = "process_packet_time"
+CONF_PUBLISH_TIME = "publish_time"
+CONF_QUEUE_HIGH_WATER = "queue_high_water"
+CONF_QUEUE_OVERFLOWS = "queue_overflows"
+CONF_RESYNCS = "resyncs"
 CONF_UV_INDEX = "uv_index"
 CONF_UV_INTENSITY = "uv_intensity"
 CONF_WIND_GUST = "wind_gust"
+ICON_BATTERY_ALERT = "mdi:battery-alert-variant-outline"
+ICON_BATTERY_CLOCK = "mdi:battery-clock-outline"
+ICON_CLOCK_FAST = "mdi:clock-fast"
+ICON_LAN_CONNECT = "mdi:lan-connect"
+ICON_MEMORY = "mdi:memory"
+ICON_SHIELD_ALERT = "mdi:shield-alert-outline"
 ICON_SUN_WIRELESS = "mdi:sun-wireless-outline"
+ICON_TIMER_OUTLINE = "mdi:timer-outline"
+ICON_TRANSMISSION_TOWER = "mdi:transmission-tower"
+ICON_TRAY_FULL = "mdi:tray-full"
+UNIT_BYTES = "B"
+UNIT_DAYS = "d"
+UNIT_FRAMES = "frames"
+UNIT_FRAMES_PER_HOUR = "frames/h"
 UNIT_METER_PER_SECOND = "m/s"
+UNIT_MICROSECOND = "µs"
 UNIT_MILLIMETERS = "mm"
 UNIT_MILLIMETERS_PER_HOUR = "mm/h"
+UNIT_PARTS_PER_MILLION = "ppm"
 UNIT_ULTRAVIOLET_INTENSITY = "mW/m²"
 
 TYPES = [
@@ -56,8 +102,79 @@ TYPES = [
     CONF_LIGHT,
     CONF_UV_INTENSITY,
     CONF_UV_INDEX,
+    CONF_FRAMES_OK,
+    CONF_CHECKSUM_FAILURES,
+    CONF_PRESSURE_FAILURES,
+    CONF_RESYNCS,
+    CONF_BYTES_DISCARDED,
+    CONF_FRAMES_PER_HOUR,
+    CONF_MISSED_TRANSMISSIONS,
+    CONF_LINK_QUALITY,
+    CONF_INTER_ARRIVAL_JITTER,
+    CONF_FILTER_REJECTIONS,
+    CONF_DEGRADED_FIELDS,
+    CONF_BATTERY_LOW_RATIO,
+    CONF_BATTERY_DAYS_TO_FAILURE,
+    CONF_QUEUE_HIGH_WATER,
+    CONF_QUEUE_OVERFLOWS,
+    CONF_CLOCK_DRIFT,
 ]
 
+# Keys of the frame message, Home Assistant reads these sensors from it without mqtt_frame entity_states
+FRAME_KEYS = {
+    CONF_TEMPERATURE: "temperature",
+    CONF_HUMIDITY: "humidity",
+    CONF_PRESSURE: "pressure",
+    CONF_WIND_SPEED: "wind_speed",
+    CONF_WIND_DIRECTION_DEGREES: "wind_direction",
+    CONF_WIND_GUST: "wind_gust",
+    CONF_ACCUMULATED_PRECIPITATION: "accumulated_precipitation",
+    CONF_PRECIPITATION_INTENSITY: "precipitation_intensity",
+    CONF_LIGHT: "light",
+    CONF_UV_INTENSITY: "uv_intensity",
+    CONF_UV_INDEX: "uv_index",
+}
+
+MEMORY_WATERMARK_TYPES = [
+    CONF_MIN_FREE_HEAP,
+    CONF_MIN_LARGEST_FREE_BLOCK,
+    CONF_MIN_STACK_HEADROOM,
+]
+
+ProfileSection = misol_ns.enum("ProfileSection")
+ProfileStatistic = misol_ns.enum("ProfileStatistic")
+PROFILE_SECTIONS = {
+    CONF_LOOP_TIME: ProfileSection.PROFILE_LOOP,
+    CONF_CHECK_PACKET_TIME: ProfileSection.PROFILE_CHECK_PACKET,
+    CONF_PROCESS_PACKET_TIME: ProfileSection.PROFILE_PROCESS_PACKET,
+    CONF_PUBLISH_TIME: ProfileSection.PROFILE_PUBLISH,
+}
+PROFILE_STATISTICS = {
+    CONF_P50: ProfileStatistic.PROFILE_P50,
+    CONF_P99: ProfileStatistic.PROFILE_P99,
+    CONF_MAX: ProfileStatistic.PROFILE_MAX,
+}
+
+FrameMQTTSensor = misol_ns.class_("FrameMQTTSensor", mqtt.MQTTSensorComponent)
+FRAME_MQTT_SCHEMA = cv.Schema(
+    {
+        cv.OnlyWith(CONF_MQTT_ID, "mqtt"): cv.declare_id(FrameMQTTSensor),
+    }
+)
+
+PROFILE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(statistic): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MICROSECOND,
+            accuracy_decimals=1,
+            icon=ICON_TIMER_OUTLINE,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        )
+        for statistic in PROFILE_STATISTICS
+    }
+)
+
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
@@ -67,66 +184,198 @@ CONFIG_SCHEMA = cv.All(
                 accuracy_decimals=1,
                 device_class=DEVICE_CLASS_TEMPERATURE,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_HUMIDITY): sensor.sensor_schema(
                 unit_of_measurement=UNIT_PERCENT,
                 accuracy_decimals=2,
                 device_class=DEVICE_CLASS_HUMIDITY,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_PRESSURE): sensor.sensor_schema(
                 unit_of_measurement=UNIT_HECTOPASCAL,
                 accuracy_decimals=2,
                 device_class=DEVICE_CLASS_ATMOSPHERIC_PRESSURE,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_WIND_SPEED): sensor.sensor_schema(
                 unit_of_measurement=UNIT_METER_PER_SECOND,
                 accuracy_decimals=2,
                 device_class=DEVICE_CLASS_WIND_SPEED,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_WIND_DIRECTION_DEGREES): sensor.sensor_schema(
                 unit_of_measurement=UNIT_DEGREES,
                 accuracy_decimals=0,
                 icon=ICON_SIGN_DIRECTION,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_WIND_GUST): sensor.sensor_schema(
                 unit_of_measurement=UNIT_METER_PER_SECOND,
                 accuracy_decimals=0,
                 icon=ICON_WEATHER_WINDY,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_ACCUMULATED_PRECIPITATION): sensor.sensor_schema(
                 unit_of_measurement=UNIT_MILLIMETERS,
                 accuracy_decimals=1,
                 device_class=DEVICE_CLASS_PRECIPITATION,
                 state_class=STATE_CLASS_TOTAL_INCREASING,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_PRECIPITATION_INTENSITY): sensor.sensor_schema(
                 unit_of_measurement=UNIT_MILLIMETERS_PER_HOUR,
                 accuracy_decimals=2,
                 device_class=DEVICE_CLASS_PRECIPITATION_INTENSITY,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_LIGHT): sensor.sensor_schema(
                 unit_of_measurement=UNIT_LUX,
                 accuracy_decimals=1,
                 device_class=DEVICE_CLASS_ILLUMINANCE,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_UV_INTENSITY): sensor.sensor_schema(
                 unit_of_measurement=UNIT_ULTRAVIOLET_INTENSITY,
                 accuracy_decimals=1,
                 icon=ICON_SUN_WIRELESS,
                 state_class=STATE_CLASS_MEASUREMENT,
-            ),
+            ).extend(FRAME_MQTT_SCHEMA),
             cv.Optional(CONF_UV_INDEX): sensor.sensor_schema(
                 icon=ICON_SUN_WIRELESS,
                 accuracy_decimals=0,
                 device_class=STATE_CLASS_NONE,
+            ).extend(FRAME_MQTT_SCHEMA),
+            cv.Optional(CONF_FRAMES_OK): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES,
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_CHECKSUM_FAILURES): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES,
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_PRESSURE_FAILURES): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES,
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_RESYNCS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_BYTES_DISCARDED): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_FRAMES_PER_HOUR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES_PER_HOUR,
+                accuracy_decimals=0,
+                icon=ICON_TRANSMISSION_TOWER,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_MISSED_TRANSMISSIONS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LINK_QUALITY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                icon=ICON_LAN_CONNECT,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_INTER_ARRIVAL_JITTER): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                icon=ICON_TIMER_OUTLINE,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_FILTER_REJECTIONS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_DEGRADED_FIELDS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                icon=ICON_SHIELD_ALERT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_BATTERY_LOW_RATIO): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                icon=ICON_BATTERY_ALERT,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
             ),
+            cv.Optional(CONF_BATTERY_DAYS_TO_FAILURE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_DAYS,
+                accuracy_decimals=0,
+                icon=ICON_BATTERY_CLOCK,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_QUEUE_HIGH_WATER): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES,
+                accuracy_decimals=0,
+                icon=ICON_TRAY_FULL,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_QUEUE_OVERFLOWS): sensor.sensor_schema(
+                unit_of_measurement=UNIT_FRAMES,
+                accuracy_decimals=0,
+                icon=ICON_COUNTER,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_CLOCK_DRIFT): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PARTS_PER_MILLION,
+                accuracy_decimals=1,
+                icon=ICON_CLOCK_FAST,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_MIN_FREE_HEAP): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                icon=ICON_MEMORY,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_MIN_LARGEST_FREE_BLOCK): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                icon=ICON_MEMORY,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_MIN_STACK_HEADROOM): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                icon=ICON_MEMORY,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LOOP_TIME): PROFILE_SCHEMA,
+            cv.Optional(CONF_CHECK_PACKET_TIME): PROFILE_SCHEMA,
+            cv.Optional(CONF_PROCESS_PACKET_TIME): PROFILE_SCHEMA,
+            cv.Optional(CONF_PUBLISH_TIME): PROFILE_SCHEMA,
         }
     ),
 )
@@ -139,3 +388,18 @@ async def to_code(config):
         if sensor_config := config.get(key):
             sens = await sensor.new_sensor(sensor_config)
             cg.add(getattr(paren, f"set_{key}_sensor")(sens))
+            if (key in FRAME_KEYS) and (CONF_MQTT_ID in sensor_config):
+                mqtt_ = await cg.get_variable(sensor_config[CONF_MQTT_ID])
+                cg.add(mqtt_.set_frame_key(paren, FRAME_KEYS[key]))
+    for key in MEMORY_WATERMARK_TYPES:
+        if sensor_config := config.get(key):
+            cg.add_define("USE_MISOL_WEATHER_MEMORY_WATERMARKS")
+            sens = await sensor.new_sensor(sensor_config)
+            cg.add(getattr(paren, f"set_{key}_sensor")(sens))
+    for section_key, section in PROFILE_SECTIONS.items():
+        if section_config := config.get(section_key):
+            cg.add_define("USE_MISOL_WEATHER_PROFILING")
+            for statistic_key, statistic in PROFILE_STATISTICS.items():
+                if sensor_config := section_config.get(statistic_key):
+                    sens = await sensor.new_sensor(sensor_config)
+                    cg.add(paren.set_profile_sensor(section, statistic, sens))
@@ -0,0 +1,33 @@
+#include "setting_number.h"
+#ifdef USE_NUMBER
+
+namespace esphome {
+namespace misol_weather {
+
+void SettingNumber::setup() {
+  float value;
+  this->pref_ = global_preferences->make_preference<float>(this->get_object_id_hash());
+  // The other night threshold moved this one along
+  this->parent_->add_on_setting_callback([this](Setting setting, float value) {
+    if (setting != this->setting_)
+      return;
+    this->publish_state(value);
+    this->pref_.save(&value);
+  });
+  if (this->pref_.load(&value)) {
+    this->parent_->set_setting(this->setting_, value);
+  } else {
+    value = this->parent_->get_setting(this->setting_);
+  }
+  this->publish_state(value);
+}
+
+void SettingNumber::control(float value) {
+  this->parent_->set_setting(this->setting_, value);
+  this->publish_state(value);
+  this->pref_.save(&value);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_NUMBER
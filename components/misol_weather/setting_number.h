@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_NUMBER
+#include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/number/number.h"
+#include "weather_station.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Number entity bound to a runtime setting of the weather station, the value survives reboots
+class SettingNumber : public number::Number, public Component, public Parented<WeatherStation> {
+ public:
+  explicit SettingNumber(Setting setting) : setting_(setting) {}
+  void setup() override;
+  float get_setup_priority() const override { return setup_priority::HARDWARE; }
+
+ protected:
+  void control(float value) override;
+
+  Setting setting_;
+  ESPPreferenceObject pref_;
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // USE_NUMBER
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Lock-free ring for exactly one producer and one consumer task. Items are copied in and out,
+// a push into a full ring drops the new item and counts an overflow.
+template<typename T, size_t N> class SpscRing {
+  static_assert((N & (N - 1)) == 0, "Ring size must be a power of two");
+
+ public:
+  // Producer side
+  bool push(const T &item) {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    uint32_t tail = this->tail_.load(std::memory_order_acquire);
+    uint32_t used = head - tail;
+    if (used == N) {
+      this->overflows_.store(this->overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    this->items_[head & (N - 1)] = item;
+    this->head_.store(head + 1, std::memory_order_release);
+    if (used + 1 > this->high_water_.load(std::memory_order_relaxed))
+      this->high_water_.store(used + 1, std::memory_order_relaxed);
+    return true;
+  }
+  // Consumer side
+  bool pop(T &item) {
+    uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (tail == this->head_.load(std::memory_order_acquire))
+      return false;
+    item = this->items_[tail & (N - 1)];
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  static constexpr size_t capacity() { return N; }
+  // Highest number of items waiting at once
+  uint32_t get_high_water() const { return this->high_water_.load(std::memory_order_relaxed); }
+  uint32_t get_overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+
+ protected:
+  T items_[N];
+  // Free running counters, the difference is the number of items waiting
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> high_water_{0};
+  std::atomic<uint32_t> overflows_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,62 @@
+#include "udp_sender.h"
+#ifdef MISOL_WEATHER_BSD_SOCKETS
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#if defined(MISOL_WEATHER_WIFI_UDP) || defined(MISOL_WEATHER_BSD_SOCKETS)
+namespace esphome {
+namespace misol_weather {
+
+#ifdef MISOL_WEATHER_WIFI_UDP
+bool UdpSender::set_address(const std::string &address, uint16_t port) {
+  this->has_address_ = this->address_.fromString(address.c_str());
+  this->port_ = port;
+  return this->has_address_;
+}
+
+bool UdpSender::send(const uint8_t *data, size_t length) {
+  if (!this->has_address_ || !this->udp_.beginPacket(this->address_, this->port_))
+    return false;
+  this->udp_.write(data, length);
+  return this->udp_.endPacket() != 0;
+}
+
+void UdpSender::close() { this->udp_.stop(); }
+#else
+bool UdpSender::set_address(const std::string &address, uint16_t port) {
+  this->address_.sin_family = AF_INET;
+  this->address_.sin_port = htons(port);
+  this->has_address_ = inet_pton(AF_INET, address.c_str(), &this->address_.sin_addr) == 1;
+  return this->has_address_;
+}
+
+bool UdpSender::send(const uint8_t *data, size_t length) {
+  if (!this->has_address_)
+    return false;
+  if (this->fd_ < 0) {
+    this->fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (this->fd_ < 0)
+      return false;
+  }
+  ssize_t sent = ::sendto(this->fd_, data, length, 0, reinterpret_cast<const struct sockaddr *>(&this->address_),
+                          sizeof(this->address_));
+  if (sent != (ssize_t) length) {
+    // The socket can be unusable after the network went down, it is opened again with the next message
+    this->close();
+    return false;
+  }
+  return true;
+}
+
+void UdpSender::close() {
+  if (this->fd_ >= 0)
+    ::close(this->fd_);
+  this->fd_ = -1;
+}
+#endif
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // MISOL_WEATHER_WIFI_UDP || MISOL_WEATHER_BSD_SOCKETS
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_RP2040)
+// WiFiUDP is only there with networking, the BSD socket branch is framework-free and builds on a host
+#include "esphome/core/defines.h"
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+#include <WiFiUdp.h>
+#define MISOL_WEATHER_WIFI_UDP
+#endif
+#else
+#include <netinet/in.h>
+#define MISOL_WEATHER_BSD_SOCKETS
+#endif
+
+#if defined(MISOL_WEATHER_WIFI_UDP) || defined(MISOL_WEATHER_BSD_SOCKETS)
+namespace esphome {
+namespace misol_weather {
+
+// Sends datagrams to a fixed IPv4 address, through WiFiUDP where the platform has no BSD sockets. The socket is
+// only opened by the first send, once the network stack is up, and again after a failed send.
+class UdpSender {
+ public:
+  ~UdpSender() { this->close(); }
+
+  // Returns false when address is not an IPv4 address
+  bool set_address(const std::string &address, uint16_t port);
+  bool send(const uint8_t *data, size_t length);
+  void close();
+
+ protected:
+#ifdef MISOL_WEATHER_WIFI_UDP
+  WiFiUDP udp_;
+  IPAddress address_;
+  uint16_t port_{0};
+  bool has_address_{false};
+#else
+  int fd_{-1};
+  struct sockaddr_in address_ {};
+  bool has_address_{false};
+#endif
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
+#endif  // MISOL_WEATHER_WIFI_UDP || MISOL_WEATHER_BSD_SOCKETS
@@ -0,0 +1,51 @@
+#include "wall_clock.h"
+
+namespace esphome {
+namespace misol_weather {
+
+// Larger differences from the prediction are a step of the reference clock, not drift
+static const int64_t MAX_SLEW_ERROR_MS = 1000;
+// Shorter intervals are dominated by the sampling error of the reference
+static const int32_t MIN_DRIFT_INTERVAL_MS = 60000;
+static const double PHASE_GAIN = 0.5;
+static const double FREQUENCY_GAIN = 0.25;
+static const double MAX_DRIFT = 500e-6;
+
+void WallClock::sync(uint32_t steady_ms, int64_t epoch_ms) {
+  if (!this->synchronized_) {
+    this->synchronized_ = true;
+    this->steps_++;
+    this->anchor_steady_ms_ = steady_ms;
+    this->anchor_epoch_ms_ = epoch_ms;
+    return;
+  }
+  int32_t elapsed = (int32_t) (steady_ms - this->anchor_steady_ms_);
+  int64_t predicted = this->to_epoch_ms(steady_ms);
+  int64_t error = epoch_ms - predicted;
+  if ((error > MAX_SLEW_ERROR_MS) || (error < -MAX_SLEW_ERROR_MS)) {
+    this->steps_++;
+    this->anchor_steady_ms_ = steady_ms;
+    this->anchor_epoch_ms_ = epoch_ms;
+    return;
+  }
+  if (elapsed >= MIN_DRIFT_INTERVAL_MS) {
+    this->drift_ += FREQUENCY_GAIN * error / elapsed;
+    if (this->drift_ > MAX_DRIFT)
+      this->drift_ = MAX_DRIFT;
+    if (this->drift_ < -MAX_DRIFT)
+      this->drift_ = -MAX_DRIFT;
+  }
+  this->anchor_steady_ms_ = steady_ms;
+  this->anchor_epoch_ms_ = predicted + (int64_t) (error * PHASE_GAIN);
+}
+
+int64_t WallClock::to_epoch_ms(uint32_t steady_ms) const {
+  if (!this->synchronized_)
+    return 0;
+  // Signed, frames can be time stamped slightly before the last sync
+  int32_t elapsed = (int32_t) (steady_ms - this->anchor_steady_ms_);
+  return this->anchor_epoch_ms_ + elapsed + (int64_t) (elapsed * this->drift_);
+}
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace misol_weather {
+
+// Maps the monotonic millisecond clock to UTC. Synchronized from reference points (the start of an
+// SNTP second), in between the rate error of the monotonic clock is corrected by a phase locked loop.
+class WallClock {
+ public:
+  // Reference clock said epoch_ms at the monotonic time steady_ms. Should be called every few minutes.
+  void sync(uint32_t steady_ms, int64_t epoch_ms);
+  bool is_synchronized() const { return this->synchronized_; }
+  // UTC time in milliseconds since the Unix epoch, 0 while not synchronized. The monotonic time must
+  // be within 24 days of the last sync.
+  int64_t to_epoch_ms(uint32_t steady_ms) const;
+  // Rate error of the monotonic clock in parts per million, positive when it runs slow
+  float get_drift_ppm() const { return this->drift_ * 1e6f; }
+  // Times the reference clock jumped instead of drifting (first sync, SNTP corrections)
+  uint32_t get_steps() const { return this->steps_; }
+
+ protected:
+  bool synchronized_{false};
+  uint32_t anchor_steady_ms_{0};
+  int64_t anchor_epoch_ms_{0};
+  double drift_{0};
+  uint32_t steps_{0};
+};
+
+}  // namespace misol_weather
+}  // namespace esphome
@@ -1,7 +1,8 @@
 #include "esphome/components/uart/uart.h"
 #include "esphome/core/helpers.h"
 #include "weather_station.h"
-#include <memory>
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 namespace {
@@ -74,13 +75,8 @@ std::string wind_speed_to_description(float speed) {
   }
 }
 
-std::string angle_to_compass_direction(float angle, bool use_3_letter_direction = false) {
-  const char* directions[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
-                              "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
-  uint8_t correction = use_3_letter_direction ? 0 : 1;
-  int index = static_cast<int>((angle + 11.25 * (1 + correction)) / (22.5 * (1 + correction))) % (8 * (2 - correction));
-  return directions[index * (1 + correction)];
-}
+const char *const COMPASS_DIRECTIONS[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+                                          "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
 
 std::string get_weather_condition(float temperature, float rain_intensity, float wind_strength, float solar_light_level, float humidity) {
   std::string condition = "Clear";
@@ -117,20 +113,6 @@ std::string get_weather_condition(float temperature, float rain_intensity, float
   return condition;
 }
 
-bool detect_night(float uv_intensity, float lower_threshold, float upper_threshold) {
-  static bool previous_result = false;
-  static bool first_run = true;
-  bool result = false;
-  if (first_run) {
-    result = uv_intensity < ((lower_threshold + upper_threshold) / 2.0f);
-    first_run = false;
-  } else {
-    result = previous_result ? (uv_intensity < upper_threshold) : (uv_intensity < lower_threshold);
-  }
-  previous_result = result;
-  return result;
-}
-
 }  // namespace
 
 namespace esphome {
@@ -140,158 +122,596 @@ static const char *const TAG = "misol_weather";
 constexpr std::chrono::milliseconds COMMUNICATION_TIMOUT = std::chrono::minutes(2);
 constexpr std::chrono::milliseconds PRECIPITATION_INTENSITY_INTERVAL = std::chrono::minutes(3);
 
+static uint32_t to_milliseconds(const std::chrono::steady_clock::time_point &time_point) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(time_point.time_since_epoch()).count();
+}
+
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+static float memory_to_state(uint32_t bytes) { return (bytes != MEMORY_NOT_AVAILABLE) ? bytes : NAN; }
+#endif
+
+constexpr uint32_t DIAGNOSTICS_UPDATE_INTERVAL_MS = 60000;
+
+// Inputs of the derived outputs, an output is only recomputed and published when one of them changed.
+// The bit after the fields stands for a new precipitation intensity value.
+constexpr uint16_t PRECIPITATION_INTENSITY_CHANGED = 1 << FIELD_COUNT;
+constexpr uint16_t WIND_DIRECTION_TEXT_INPUTS = field_mask(FIELD_WIND_DIRECTION);
+constexpr uint16_t WIND_SPEED_TEXT_INPUTS = field_mask(FIELD_WIND_SPEED);
+constexpr uint16_t UV_INDEX_INPUTS = field_mask(FIELD_UV_INTENSITY);
+constexpr uint16_t NIGHT_INPUTS = field_mask(FIELD_UV_INTENSITY);
+constexpr uint16_t LIGHT_TEXT_INPUTS = field_mask(FIELD_LIGHT);
+constexpr uint16_t WEATHER_CONDITIONS_INPUTS =
+    field_mask(FIELD_TEMPERATURE, FIELD_HUMIDITY, FIELD_WIND_SPEED, FIELD_LIGHT) | PRECIPITATION_INTENSITY_CHANGED;
+#ifdef USE_TIME
+constexpr uint32_t WALL_CLOCK_SYNC_INTERVAL_MS = 10 * 60 * 1000;
+// Reference clocks before 2020 are not set yet
+constexpr time_t MIN_VALID_EPOCH = 1577836800;
+#endif
+
+void WeatherStation::setup() {
+  // Start, data and stop bits, the UART format is enforced by the config validation
+  this->character_time_ = std::chrono::microseconds(10 * 1000000UL / this->parent_->get_baud_rate());
+  this->set_interval("diagnostics", DIAGNOSTICS_UPDATE_INTERVAL_MS, [this]() { this->update_diagnostics_(); });
+#ifdef USE_MISOL_WEATHER_UART_EVENT
+  if (!this->setup_uart_events_())
+    ESP_LOGW(TAG, "UART events are not available, polling the UART");
+#endif
+#ifdef USE_MISOL_WEATHER_TASK
+  if (!this->start_rx_task_())
+    ESP_LOGW(TAG, "Receive task is not available, polling the UART");
+#endif
+#ifdef USE_MISOL_WEATHER_DMA
+  if (!this->start_dma_())
+    ESP_LOGW(TAG, "UART DMA is not available, polling the UART");
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+  // The socket is opened with the first message, the network stack is not initialized yet
+  if (!this->influxdb_sender_.set_address(this->influxdb_address_, this->influxdb_port_))
+    ESP_LOGW(TAG, "Invalid InfluxDB address %s", this->influxdb_address_.c_str());
+#endif
+}
+
 void WeatherStation::loop() {
+#ifdef USE_MISOL_WEATHER_PROFILING
+  ProfileScope profile(this->histograms_[PROFILE_LOOP]);
+#endif
+#if defined(USE_MISOL_WEATHER_METRICS) || defined(USE_MISOL_WEATHER_HISTORY)
+  LockGuard state_lock(this->state_lock_);
+#endif
   // Checking timeout
   std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-  if (this->first_data_received_ && (now - this->last_packet_time_ > COMMUNICATION_TIMOUT)) {
+  if (this->first_data_received_ && (now - this->last_packet_time_ > this->get_communication_timeout_())) {
     ESP_LOGW(TAG, "Communication timeout");
     this->first_data_received_ = false;
-    this->reset_sub_entities_();
   }
-  auto size = this->available();
+  this->check_stale_fields_(now);
+#ifdef USE_TIME
+  if (this->time_ != nullptr)
+    this->update_wall_clock_(now);
+#endif
+#ifdef USE_MISOL_WEATHER_TASK
+  if (this->rx_task_handle_ != nullptr) {
+    this->process_frame_queue_();
+    return;
+  }
+#endif
+#ifdef USE_MISOL_WEATHER_DMA
+  if (this->dma_channel_ >= 0) {
+    this->process_dma_ring_(now);
+    return;
+  }
+#endif
+#ifdef USE_MISOL_WEATHER_UART_EVENT
+  // Frames end with an RX timeout event, the idle gap only catches an event lost to a queue overflow
+  bool use_events = this->uart_event_queue_ != nullptr;
+  if (use_events)
+    this->process_uart_events_(now);
+  int size = use_events ? 0 : this->available();
+#else
+  int size = this->available();
+#endif
   if (size > 0) {
-    std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
-    for (int i = 0; i < size; i++) {
-      buffer[i] = this->read();
-    }
-    ESP_LOGD(TAG, "%s received: %s", this->first_data_received_ ? "Packet" : "First packet",
-             format_hex_pretty(buffer.get(), size).c_str());
-    this->first_data_received_ = true;
+    this->read_rx_data_(size, now);
     this->last_packet_time_ = now;
-    PacketType packet_type = check_packet_(buffer.get(), size);
-    if (packet_type != PacketType::WRONG_PACKET) {
-      this->process_packet_(buffer.get(), size, packet_type == PacketType::BASIC_WITH_PRESSURE, now);
-    } else {
-      ESP_LOGW(TAG, "Unknown packet received: %s", format_hex_pretty(buffer.get(), size).c_str());
+  } else if ((this->rx_length_ > 0) && (now - this->last_packet_time_ > FRAME_IDLE_GAP)) {
+    // Line is idle, everything received so far belongs to finished frames
+    ESP_LOGV(TAG, "%s received: %s", this->first_data_received_ ? "Packet" : "First packet",
+             format_hex_pretty(this->rx_buffer_, this->rx_length_).c_str());
+    this->first_data_received_ = true;
+    this->parse_rx_buffer_(true);
+  }
+}
+
+#ifdef USE_TIME
+void WeatherStation::update_wall_clock_(const std::chrono::steady_clock::time_point &now) {
+  uint32_t steady_ms = to_milliseconds(now);
+  if (this->wall_clock_.is_synchronized() && (steady_ms - this->last_clock_sync_ms_ < WALL_CLOCK_SYNC_INTERVAL_MS))
+    return;
+  time_t second = this->time_->timestamp_now();
+  if (second < MIN_VALID_EPOCH)
+    return;
+  if (this->clock_second_ == 0) {
+    // The reference only has a resolution of a second, waiting for the start of the next one
+    this->clock_second_ = second;
+    return;
+  }
+  if (second == this->clock_second_)
+    return;
+  bool first_sync = !this->wall_clock_.is_synchronized();
+  this->wall_clock_.sync(steady_ms, ((int64_t) second) * 1000);
+  this->last_clock_sync_ms_ = steady_ms;
+  this->clock_second_ = 0;
+  ESP_LOGV(TAG, "Wall clock synchronized, drift %.1f ppm", this->wall_clock_.get_drift_ppm());
+  if (first_sync)
+    this->schedule_aligned_diagnostics_();
+}
+#endif  // USE_TIME
+
+void WeatherStation::schedule_aligned_diagnostics_() {
+  int64_t epoch_ms = this->wall_clock_.to_epoch_ms(to_milliseconds(std::chrono::steady_clock::now()));
+  uint32_t delay = DIAGNOSTICS_UPDATE_INTERVAL_MS - (uint32_t) (epoch_ms % DIAGNOSTICS_UPDATE_INTERVAL_MS);
+  this->cancel_interval("diagnostics");
+  this->set_timeout("diagnostics", delay, [this]() {
+    this->update_diagnostics_();
+    this->schedule_aligned_diagnostics_();
+  });
+}
+
+void WeatherStation::read_rx_data_(size_t size, const std::chrono::steady_clock::time_point &now) {
+  while (size > 0) {
+    if (this->rx_length_ == RX_BUFFER_SIZE) {
+      // Buffer is full without an idle gap, extract complete frames to make room
+      this->parse_rx_buffer_(false);
+    }
+    size_t chunk = std::min(size, RX_BUFFER_SIZE - this->rx_length_);
+    if (!this->read_array(this->rx_buffer_ + this->rx_length_, chunk)) {
+      return;
     }
+    this->rx_length_ += chunk;
+    this->update_rx_start_time_(now, chunk);
+    size -= chunk;
+  }
+}
+
+void WeatherStation::update_rx_start_time_(const std::chrono::steady_clock::time_point &last_byte_time,
+                                           size_t new_bytes) {
+  // Bytes arrive back to back at best, the first byte in the buffer is at least this old. Every read
+  // gives such a bound, the tightest one is kept.
+  std::chrono::steady_clock::time_point start = last_byte_time - this->character_time_ * (int) (this->rx_length_ - 1);
+  if ((new_bytes == this->rx_length_) || (start < this->rx_start_time_))
+    this->rx_start_time_ = start;
+}
+
+void WeatherStation::parse_rx_buffer_(bool flush) {
+  size_t offset = scan_frames(
+      this->rx_buffer_, this->rx_length_, flush,
+      [this](const uint8_t *data, size_t len) { return this->check_packet_(data, len); },
+      [this](size_t frame_offset, size_t len, FrameResult result) {
+        // Arrival time of the first byte of the frame
+        this->dispatch_frame_(this->rx_buffer_ + frame_offset, len, result,
+                              this->rx_start_time_ + this->character_time_ * (int) frame_offset);
+      },
+      [this](size_t count, bool in_sync) { this->discard_rx_bytes_(count, in_sync); });
+  if (offset > 0) {
+    this->rx_length_ -= offset;
+    memmove(this->rx_buffer_, this->rx_buffer_ + offset, this->rx_length_);
+    this->rx_start_time_ += this->character_time_ * (int) offset;
   }
 }
 
-void WeatherStation::reset_sub_entities_() {
+void WeatherStation::dispatch_frame_(const uint8_t *data, size_t len, FrameResult result,
+                                     const std::chrono::steady_clock::time_point &now) {
+#ifdef USE_MISOL_WEATHER_TASK
+  if (this->rx_task_handle_ != nullptr) {
+    // Runs in the receive task, the main loop handles the frame
+    FrameRecord record;
+    record.timestamp = now;
+    record.result = result;
+    record.length = std::min(len, sizeof(record.data));
+    memcpy(record.data, data, record.length);
+    this->frame_queue_.push(record);
+    return;
+  }
+#endif
+  this->handle_frame_(data, len, result, now);
+}
+
+void WeatherStation::handle_frame_(const uint8_t *data, size_t len, FrameResult result,
+                                   const std::chrono::steady_clock::time_point &now) {
+  this->flight_recorder_.record(data, len, to_milliseconds(now), result);
+  switch (result) {
+    case FrameResult::TRUNCATED:
+      ESP_LOGW(TAG, "Truncated packet received, %u bytes discarded", (unsigned) len);
+      return;
+    case FrameResult::CHECKSUM_FAILURE:
+      ESP_LOGW(TAG, "Packet checksum mismatch, resynchronizing");
+      this->link_statistics_.checksum_failures++;
+      return;
+    case FrameResult::PRESSURE_CHECKSUM_FAILURE:
+      ESP_LOGW(TAG, "Pressure checksum mismatch");
+      this->link_statistics_.pressure_failures++;
+      break;
+    default:
+      break;
+  }
+  this->link_statistics_.frames_ok++;
+  this->cadence_tracker_.add_arrival(to_milliseconds(now));
+  this->process_packet_(data, len, result == FrameResult::BASIC_WITH_PRESSURE, now);
+}
+
+void WeatherStation::discard_rx_bytes_(size_t count, bool in_sync) {
+#ifdef USE_MISOL_WEATHER_TASK
+  if (this->rx_task_handle_ != nullptr) {
+    // Runs in the receive task, link_statistics_ belongs to the main loop
+    if (in_sync)
+      this->task_resyncs_.fetch_add(1, std::memory_order_relaxed);
+    this->task_bytes_discarded_.fetch_add(count, std::memory_order_relaxed);
+    return;
+  }
+#endif
+  if (in_sync)
+    this->link_statistics_.resyncs++;
+  this->link_statistics_.bytes_discarded += count;
+}
+
+void WeatherStation::update_diagnostics_() {
+  uint32_t frames_ok = this->link_statistics_.frames_ok;
+  this->frames_per_minute_[this->frames_per_minute_index_] = frames_ok - this->frames_ok_at_last_update_;
+  this->frames_ok_at_last_update_ = frames_ok;
+  this->frames_per_minute_index_ = (this->frames_per_minute_index_ + 1) % 60;
+  if (this->frames_per_minute_filled_ < 60)
+    this->frames_per_minute_filled_++;
 #ifdef USE_SENSOR
-  if (this->temperature_sensor_ != nullptr)
-    this->temperature_sensor_->publish_state(NAN);
-  if (this->humidity_sensor_ != nullptr)
-    this->humidity_sensor_->publish_state(NAN);
-  if (this->pressure_sensor_ != nullptr)
-    this->pressure_sensor_->publish_state(NAN);
-  if (this->wind_speed_sensor_ != nullptr)
-    this->wind_speed_sensor_->publish_state(NAN);
-  if (this->wind_gust_sensor_ != nullptr)
-    this->wind_gust_sensor_->publish_state(NAN);
-  if (this->wind_direction_degrees_sensor_ != nullptr)
-    this->wind_direction_degrees_sensor_->publish_state(NAN);
-  if (this->accumulated_precipitation_sensor_ != nullptr)
-    this->accumulated_precipitation_sensor_->publish_state(NAN);
-  if (this->uv_intensity_sensor_ != nullptr)
-    this->uv_intensity_sensor_->publish_state(NAN);
-  if (this->light_sensor_ != nullptr)
-    this->light_sensor_->publish_state(NAN);
-  if (this->uv_index_sensor_ != nullptr)
-    this->uv_index_sensor_->publish_state(NAN);
-  if (this->precipitation_intensity_sensor_ != nullptr) {
-    this->precipitation_intensity_sensor_->publish_state(NAN);
-    this->previous_precipitation_.reset();
+  if (this->frames_ok_sensor_ != nullptr)
+    this->frames_ok_sensor_->publish_state(frames_ok);
+  if (this->checksum_failures_sensor_ != nullptr)
+    this->checksum_failures_sensor_->publish_state(this->link_statistics_.checksum_failures);
+  if (this->pressure_failures_sensor_ != nullptr)
+    this->pressure_failures_sensor_->publish_state(this->link_statistics_.pressure_failures);
+  if (this->resyncs_sensor_ != nullptr)
+    this->resyncs_sensor_->publish_state(this->link_statistics_.resyncs);
+  if (this->bytes_discarded_sensor_ != nullptr)
+    this->bytes_discarded_sensor_->publish_state(this->link_statistics_.bytes_discarded);
+  if (this->frames_per_hour_sensor_ != nullptr) {
+    // Extrapolating until a full hour of history is collected
+    uint32_t frames = 0;
+    for (uint8_t i = 0; i < this->frames_per_minute_filled_; i++)
+      frames += this->frames_per_minute_[i];
+    this->frames_per_hour_sensor_->publish_state(frames * 60.0f / this->frames_per_minute_filled_);
+  }
+  if (this->missed_transmissions_sensor_ != nullptr)
+    this->missed_transmissions_sensor_->publish_state(this->cadence_tracker_.get_missed_transmissions());
+  if (this->link_quality_sensor_ != nullptr)
+    this->link_quality_sensor_->publish_state(
+        this->cadence_tracker_.get_link_quality(to_milliseconds(std::chrono::steady_clock::now())));
+  if (this->inter_arrival_jitter_sensor_ != nullptr)
+    this->inter_arrival_jitter_sensor_->publish_state(this->cadence_tracker_.get_jitter_ms());
+  if ((this->filter_rejections_sensor_ != nullptr) && (this->frame_filter_ != nullptr))
+    this->filter_rejections_sensor_->publish_state(this->frame_filter_->get_rejections());
+  if (this->battery_low_ratio_sensor_ != nullptr)
+    this->battery_low_ratio_sensor_->publish_state(this->battery_monitor_.get_low_ratio());
+  if (this->battery_days_to_failure_sensor_ != nullptr)
+    this->battery_days_to_failure_sensor_->publish_state(this->battery_monitor_.get_days_to_failure());
+#ifdef USE_MISOL_WEATHER_TASK
+  if (this->queue_high_water_sensor_ != nullptr)
+    this->queue_high_water_sensor_->publish_state(this->frame_queue_.get_high_water());
+  if (this->queue_overflows_sensor_ != nullptr)
+    this->queue_overflows_sensor_->publish_state(this->frame_queue_.get_overflows());
+#endif
+  if ((this->clock_drift_sensor_ != nullptr) && this->wall_clock_.is_synchronized())
+    this->clock_drift_sensor_->publish_state(this->wall_clock_.get_drift_ppm());
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+  if (this->min_free_heap_sensor_ != nullptr)
+    this->min_free_heap_sensor_->publish_state(memory_to_state(this->memory_watermarks_.min_free_heap));
+  if (this->min_largest_free_block_sensor_ != nullptr)
+    this->min_largest_free_block_sensor_->publish_state(
+        memory_to_state(this->memory_watermarks_.min_largest_free_block));
+  if (this->min_stack_headroom_sensor_ != nullptr)
+    this->min_stack_headroom_sensor_->publish_state(memory_to_state(this->memory_watermarks_.min_stack_headroom));
+#endif  // USE_MISOL_WEATHER_MEMORY_WATERMARKS
+#ifdef USE_MISOL_WEATHER_PROFILING
+  static const uint8_t PERCENTILES[] = {50, 99};
+  float ticks_per_us = get_profiler_ticks_per_us();
+  for (uint8_t section = 0; section < PROFILE_SECTION_COUNT; section++) {
+    for (uint8_t statistic = 0; statistic < PROFILE_STATISTIC_COUNT; statistic++) {
+      sensor::Sensor *sens = this->profile_sensors_[section][statistic];
+      if (sens == nullptr)
+        continue;
+      uint32_t ticks = (statistic == PROFILE_MAX) ? this->histograms_[section].get_max()
+                                                  : this->histograms_[section].get_percentile(PERCENTILES[statistic]);
+      sens->publish_state(ticks / ticks_per_us);
+    }
   }
+#endif  // USE_MISOL_WEATHER_PROFILING
 #endif  // USE_SENSOR
 }
 
-PacketType WeatherStation::check_packet_(const uint8_t *data, size_t len) {
-  // Checking basic packet
-  if (len < 17) {
-    return PacketType::WRONG_PACKET;
-  }
-  if (data[0] != 0x24) {
-    return PacketType::WRONG_PACKET;
-  }
-  uint8_t checksum = 0;
-  for (int i = 0; i < 16; i++) {
-    checksum += data[i];
-  }
-  if (checksum != data[16]) {
-    return PacketType::WRONG_PACKET;
-  }
-  // Checking barometry pressure packet
-  if (len > 17) {
-    if (len < 21) {
-      return PacketType::BASIC_PACKET;
-    }
-    checksum = 0;
-    for (int i = 17; i < 20; i++) {
-      checksum += data[i];
+std::chrono::milliseconds WeatherStation::get_communication_timeout_() const {
+  if (this->communication_timeout_.has_value())
+    return this->communication_timeout_.value();
+  uint32_t period = this->cadence_tracker_.get_period_ms();
+  if (period == 0)
+    return COMMUNICATION_TIMOUT;
+  return std::chrono::milliseconds(period * this->timeout_periods_);
+}
+
+uint16_t WeatherStation::update_field_freshness_(const DecodedFrame &frame,
+                                                 const std::chrono::steady_clock::time_point &now) {
+  uint16_t stale_fields = 0;
+  for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+    if (frame.is_available((Field) field)) {
+      this->field_updated_[field] = now;
+      this->fresh_fields_ |= 1 << field;
+    } else if (!(this->fresh_fields_ & (1 << field)) &&
+               (this->field_updated_[field] != std::chrono::steady_clock::time_point())) {
+      // Fields that were never received (e.g. pressure without the pressure module) are not stale
+      stale_fields |= 1 << field;
     }
-    if (checksum != data[20]) {
-      return PacketType::BASIC_PACKET;
+  }
+  return stale_fields;
+}
+
+void WeatherStation::check_stale_fields_(const std::chrono::steady_clock::time_point &now) {
+  if (this->fresh_fields_ == 0)
+    return;
+  std::chrono::milliseconds timeout = this->get_communication_timeout_();
+  for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+    if ((this->fresh_fields_ & (1 << field)) && (now - this->field_updated_[field] > timeout)) {
+      ESP_LOGW(TAG, "%s value is stale", field_to_string((Field) field));
+      this->fresh_fields_ &= ~(1 << field);
+      // Only one field per loop iteration to spread the publishing
+      this->reset_field_entities_((Field) field);
+      return;
     }
-    return PacketType::BASIC_WITH_PRESSURE;
   }
-  return PacketType::BASIC_PACKET;
+}
+
+void WeatherStation::reset_field_entities_(Field field) {
+  this->forced_inputs_ |= 1 << field;
+  switch (field) {
+    case FIELD_WIND_DIRECTION:
+#ifdef USE_SENSOR
+      if (this->wind_direction_degrees_sensor_ != nullptr)
+        this->wind_direction_degrees_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+#ifdef USE_TEXT_SENSOR
+      if (this->wind_direction_text_sensor_ != nullptr)
+        this->wind_direction_text_sensor_->publish_state("Unknown");
+#endif  // USE_TEXT_SENSOR
+      break;
+    case FIELD_LOW_BATTERY:
+#ifdef USE_BINARY_SENSOR
+      if (this->battery_level_binary_sensor_ != nullptr)
+        this->battery_level_binary_sensor_->invalidate_state();
+#endif  // USE_BINARY_SENSOR
+      break;
+    case FIELD_TEMPERATURE:
+#ifdef USE_SENSOR
+      if (this->temperature_sensor_ != nullptr)
+        this->temperature_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+      break;
+    case FIELD_HUMIDITY:
+#ifdef USE_SENSOR
+      if (this->humidity_sensor_ != nullptr)
+        this->humidity_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+      break;
+    case FIELD_WIND_SPEED:
+#ifdef USE_SENSOR
+      if (this->wind_speed_sensor_ != nullptr)
+        this->wind_speed_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+#ifdef USE_TEXT_SENSOR
+      if (this->wind_speed_text_sensor_ != nullptr)
+        this->wind_speed_text_sensor_->publish_state("Unknown");
+#endif  // USE_TEXT_SENSOR
+      break;
+    case FIELD_WIND_GUST:
+#ifdef USE_SENSOR
+      if (this->wind_gust_sensor_ != nullptr)
+        this->wind_gust_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+      break;
+    case FIELD_PRECIPITATION:
+#if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
+      this->precipitation_window_.reset();
+      this->forced_inputs_ |= PRECIPITATION_INTENSITY_CHANGED;
+#endif  // USE_SENSOR || USE_TEXT_SENSOR
+#ifdef USE_SENSOR
+      if (this->accumulated_precipitation_sensor_ != nullptr)
+        this->accumulated_precipitation_sensor_->publish_state(NAN);
+      if (this->precipitation_intensity_sensor_ != nullptr)
+        this->precipitation_intensity_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+#ifdef USE_TEXT_SENSOR
+      if (this->precipitation_intensity_text_sensor_ != nullptr)
+        this->precipitation_intensity_text_sensor_->publish_state("Unknown");
+#endif  // USE_TEXT_SENSOR
+      break;
+    case FIELD_UV_INTENSITY:
+#ifdef USE_SENSOR
+      if (this->uv_intensity_sensor_ != nullptr)
+        this->uv_intensity_sensor_->publish_state(NAN);
+      if (this->uv_index_sensor_ != nullptr)
+        this->uv_index_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+#ifdef USE_BINARY_SENSOR
+      if (this->night_binary_sensor_ != nullptr)
+        this->night_binary_sensor_->invalidate_state();
+      this->night_.reset();
+#endif  // USE_BINARY_SENSOR
+      break;
+    case FIELD_LIGHT:
+#ifdef USE_SENSOR
+      if (this->light_sensor_ != nullptr)
+        this->light_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+#ifdef USE_TEXT_SENSOR
+      if (this->light_text_sensor_ != nullptr)
+        this->light_text_sensor_->publish_state("Unknown");
+#endif  // USE_TEXT_SENSOR
+      break;
+    case FIELD_PRESSURE:
+#ifdef USE_SENSOR
+      if (this->pressure_sensor_ != nullptr)
+        this->pressure_sensor_->publish_state(NAN);
+#endif  // USE_SENSOR
+      break;
+    default:
+      break;
+  }
+#ifdef USE_TEXT_SENSOR
+  if ((this->fresh_fields_ == 0) && (this->weather_conditions_text_sensor_ != nullptr))
+    this->weather_conditions_text_sensor_->publish_state("Unknown");
+#endif  // USE_TEXT_SENSOR
+}
+
+PacketType WeatherStation::check_packet_(const uint8_t *data, size_t len) {
+#ifdef USE_MISOL_WEATHER_PROFILING
+#ifdef USE_MISOL_WEATHER_TASK
+  // The histograms belong to the main loop, checks in the receive task are not profiled
+  if (this->rx_task_handle_ != nullptr)
+    return check_packet(data, len);
+#endif
+  ProfileScope profile(this->histograms_[PROFILE_CHECK_PACKET]);
+#endif
+  return check_packet(data, len);
 }
 
 void WeatherStation::process_packet_(const uint8_t *data, size_t len, bool has_pressure,
                                      const std::chrono::steady_clock::time_point &now) {
-#ifdef USE_SENSOR
-  if (this->pressure_sensor_ != nullptr) {
-    if (has_pressure) {
-      float pressure = ((((uint32_t) data[17]) << 16) + (((uint32_t) data[18]) << 8) + data[19]) / 100.0f;
-      this->pressure_sensor_->publish_state(pressure);
-    } else {
-      this->pressure_sensor_->publish_state(NAN);
+#ifdef USE_MISOL_WEATHER_PROFILING
+  ProfileScope profile(this->histograms_[PROFILE_PROCESS_PACKET]);
+#endif
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+  MemorySnapshot before = MemorySnapshot::take();
+  this->memory_watermarks_.update(before);
+#endif
+  DecodedFrame frame;
+  decode_frame(data, len, has_pressure, frame);
+  frame.epoch_ms = this->wall_clock_.to_epoch_ms(to_milliseconds(now));
+  if (this->frame_filter_ != nullptr) {
+    uint16_t filtered_fields = this->frame_filter_->apply(frame);
+    if (filtered_fields != 0)
+      ESP_LOGD(TAG, "Outliers replaced, fields mask: 0x%03X", filtered_fields);
+    frame.add_quality(filtered_fields, QUALITY_FILTERED);
+  }
+  frame.add_quality(this->update_field_freshness_(frame, now), QUALITY_STALE);
+  this->battery_monitor_.update(frame.low_battery, to_milliseconds(now));
+  uint16_t changed_fields = this->has_previous_frame_ ? frame.get_changed_fields(this->previous_frame_) : 0xFFFF;
+  this->previous_frame_ = frame;
+  this->has_previous_frame_ = true;
+  this->update_fault_detectors_(frame, changed_fields, now);
+  this->flight_recorder_.set_processed(frame);
+  if (frame.quality != 0) {
+    ESP_LOGV(TAG, "Quality flags: 0x%010llX", (unsigned long long) frame.quality);
+  }
+  {
+#ifdef USE_MISOL_WEATHER_PROFILING
+    ProfileScope profile(this->histograms_[PROFILE_PUBLISH]);
+#endif
+    this->publish_frame_(frame, changed_fields, now);
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+    this->publish_mqtt_frame_(frame);
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+    this->send_influxdb_frame_(frame);
+#endif
+  }
+  uint32_t timestamp_ms = to_milliseconds(now);
+  this->frame_callback_.call(frame, timestamp_ms);
+  Edge rain_edge = this->rain_detector_.update(frame.precipitation, timestamp_ms);
+  if (rain_edge != Edge::NONE)
+    this->rain_callback_.call(rain_edge == Edge::RISING);
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+  MemorySnapshot after = MemorySnapshot::take();
+  this->memory_watermarks_.update(after);
+  if (after.free_heap < before.free_heap) {
+    ESP_LOGV(TAG, "Free heap decreased by %u bytes while processing the packet",
+             (unsigned) (before.free_heap - after.free_heap));
+  }
+#endif
+}
+
+void WeatherStation::update_fault_detectors_(DecodedFrame &frame, uint16_t changed_fields,
+                                             const std::chrono::steady_clock::time_point &now) {
+#ifdef USE_BINARY_SENSOR
+  // Measurements that keep changing in a working station, a flat line only counts while they change
+  static const uint16_t CONDITION_FIELDS = (1 << FIELD_WIND_DIRECTION) | (1 << FIELD_TEMPERATURE) |
+                                           (1 << FIELD_HUMIDITY) | (1 << FIELD_WIND_SPEED) |
+                                           (1 << FIELD_UV_INTENSITY) | (1 << FIELD_LIGHT) | (1 << FIELD_PRESSURE);
+  uint32_t timestamp = to_milliseconds(now);
+  for (uint8_t field = 0; field < FIELD_COUNT; field++) {
+    FieldFault *fault = this->field_faults_[field].get();
+    if (fault == nullptr)
+      continue;
+    bool conditions_changed = (changed_fields & CONDITION_FIELDS & ~(1 << field)) != 0;
+    fault->detector.update(frame.get_value((Field) field), timestamp, conditions_changed);
+    if (fault->detector.is_out_of_range())
+      frame.add_quality((Field) field, QUALITY_OUT_OF_RANGE);
+    bool has_fault = fault->detector.has_fault();
+    if (has_fault && !fault->binary_sensor->state) {
+      ESP_LOGW(TAG, "%s sensor fault detected (%s)", field_to_string((Field) field),
+               fault->detector.is_out_of_range() ? "out of range" : "flat line");
     }
+    fault->binary_sensor->publish_state(has_fault);
   }
-#endif  // USE_SENSOR
+#endif  // USE_BINARY_SENSOR
+}
+
+void WeatherStation::publish_frame_(const DecodedFrame &frame, uint16_t changed_fields,
+                                    const std::chrono::steady_clock::time_point &now) {
+  // Outputs reset by staleness have to be published again even if the value is the same as before
+  changed_fields |= this->forced_inputs_;
+  this->forced_inputs_ = 0;
 #ifdef USE_SENSOR
+  if (this->degraded_fields_sensor_ != nullptr) {
+    this->degraded_fields_sensor_->publish_state(frame.get_degraded_fields());
+  }
+  // Frames with a missing or corrupted pressure trailer keep the last pressure until it becomes stale
+  if ((this->pressure_sensor_ != nullptr) && frame.has_pressure) {
+    this->pressure_sensor_->publish_state(frame.get_pressure());
+  }
   if (this->wind_direction_degrees_sensor_ != nullptr) {
-    uint16_t wind_direction = data[2] + (((uint16_t) (data[3] & 0x80)) << 1);
-    if (wind_direction != 0x1FF) {
-      this->wind_direction_degrees_sensor_->publish_state(wind_direction);
-    } else {
-      this->wind_direction_degrees_sensor_->publish_state(NAN);
-    }
+    this->wind_direction_degrees_sensor_->publish_state(frame.get_wind_direction());
   }
 #endif  // USE_SENSOR
 #ifdef USE_TEXT_SENSOR
-  if (this->wind_direction_text_sensor_ != nullptr) {
-    uint16_t wind_direction = data[2] + (((uint16_t) (data[3] & 0x80)) << 1);
-    if (wind_direction != 0x1FF) {
-      this->wind_direction_text_sensor_->publish_state(angle_to_compass_direction(wind_direction + this->north_correction_,
-                                                                         this->secondary_intercardinal_direction_));
+  if ((this->wind_direction_text_sensor_ != nullptr) && (changed_fields & WIND_DIRECTION_TEXT_INPUTS)) {
+    if (frame.wind_direction != WIND_DIRECTION_NOT_AVAILABLE) {
+      if (this->compass_lut_dirty_)
+        this->rebuild_compass_lut_();
+      uint8_t direction = this->compass_lut_[frame.wind_direction % 360];
+      this->wind_direction_text_sensor_->publish_state(COMPASS_DIRECTIONS[direction]);
     } else {
       this->wind_direction_text_sensor_->publish_state("Unknown");
     }
   }
 #endif  // USE_TEXT_SENSOR
 #ifdef USE_BINARY_SENSOR
-  bool low_battery = (data[3] & 0x08) != 0;
   if (this->battery_level_binary_sensor_ != nullptr) {
-    this->battery_level_binary_sensor_->publish_state(low_battery);
+    this->battery_level_binary_sensor_->publish_state(this->battery_monitor_.is_low());
   }
 #endif  // USE_BINARY_SENSOR
-  uint16_t tmp_val = data[4] + (((uint16_t) (data[3] & 0x07)) << 8);
-  float temperature = (tmp_val != 0x7FF) ?  (tmp_val - 400) / 10.0 : NAN;
+  float temperature = frame.get_temperature();
+  float humidity = frame.get_humidity();
+  float wind_speed = frame.get_wind_speed();
 #ifdef USE_SENSOR
   if (this->temperature_sensor_ != nullptr) {
     this->temperature_sensor_->publish_state(temperature);
   }
-#endif  // USE_SENSOR
-  uint8_t humidity = data[5];
-#ifdef USE_SENSOR
   if (this->humidity_sensor_ != nullptr) {
     this->humidity_sensor_->publish_state(humidity);
   }
-#endif  // USE_SENSOR
-  uint16_t wind_speed_val = data[6] + (((uint16_t) (data[3] & 0x10)) << 4);
-  float wind_speed = (wind_speed_val != 0x1FF) ? wind_speed_val / 8.0 * 1.12 : NAN;
-#ifdef USE_SENSOR
   if (this->wind_speed_sensor_ != nullptr) {
     this->wind_speed_sensor_->publish_state(wind_speed);
   }
 #endif  // USE_SENSOR
 #ifdef USE_TEXT_SENSOR
-  if (this->wind_speed_text_sensor_ != nullptr) {
-    uint16_t wind_speed = data[6] + (((uint16_t) (data[3] & 0x10)) << 4);
-    if (wind_speed != 0x1FF) {
-      this->wind_speed_text_sensor_->publish_state(wind_speed_to_description(wind_speed / 8.0 * 1.12));
+  if ((this->wind_speed_text_sensor_ != nullptr) && (changed_fields & WIND_SPEED_TEXT_INPUTS)) {
+    if (frame.wind_speed != WIND_SPEED_NOT_AVAILABLE) {
+      this->wind_speed_text_sensor_->publish_state(wind_speed_to_description(wind_speed));
     } else {
       this->wind_speed_text_sensor_->publish_state("Unknown");
     }
@@ -299,36 +719,20 @@ void WeatherStation::process_packet_(const uint8_t *data, size_t len, bool has_p
 #endif  // USE_TEXT_SENSOR
 #ifdef USE_SENSOR
   if (this->wind_gust_sensor_ != nullptr) {
-    uint8_t wind_gust = data[7];
-    if (wind_gust != 0xFF) {
-      this->wind_gust_sensor_->publish_state(wind_gust * 1.12);
-    } else {
-      this->wind_gust_sensor_->publish_state(NAN);
-    }
+    this->wind_gust_sensor_->publish_state(frame.get_wind_gust());
   }
 #endif  // USE_SENSOR
 #if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
-  bool precipitation_intensity_updated = false;
-  uint16_t accumulated_precipitation = data[9] + (((uint16_t) data[8]) << 8);
-  float precipitation_intensity = NAN;
-  if (this->previous_precipitation_.has_value()) {
-    std::chrono::seconds interval =
-        std::chrono::duration_cast<std::chrono::seconds>(now - this->previous_precipitation_timestamp_);
-    if (interval > this->precipitation_intensity_interval_) {
-      precipitation_intensity = ((float) (accumulated_precipitation - this->previous_precipitation_.value())) * 0.3f /
-                                (interval.count() / 3600.0f);
-      this->previous_precipitation_ = accumulated_precipitation;
-      this->previous_precipitation_timestamp_ = now;
-      precipitation_intensity_updated = true;
-    }
-  } else {
-    this->previous_precipitation_ = accumulated_precipitation;
-    this->previous_precipitation_timestamp_ = now;
-  }
+  float previous_intensity = this->precipitation_window_.get_intensity();
+  bool precipitation_intensity_updated =
+      this->precipitation_window_.update(frame.precipitation, to_milliseconds(now), frame.epoch_ms);
+  float precipitation_intensity = this->precipitation_window_.get_intensity();
+  if (precipitation_intensity_updated && (precipitation_intensity != previous_intensity))
+    changed_fields |= PRECIPITATION_INTENSITY_CHANGED;
 #endif  // USE_SENSOR || USE_TEXT_SENSOR
 #ifdef USE_SENSOR
   if (this->accumulated_precipitation_sensor_ != nullptr) {
-    this->accumulated_precipitation_sensor_->publish_state(accumulated_precipitation * 0.3);
+    this->accumulated_precipitation_sensor_->publish_state(frame.get_accumulated_precipitation());
   }
   if ((this->precipitation_intensity_sensor_ != nullptr) && (precipitation_intensity_updated)) {
     this->precipitation_intensity_sensor_->publish_state(precipitation_intensity);
@@ -336,52 +740,235 @@ void WeatherStation::process_packet_(const uint8_t *data, size_t len, bool has_p
 #endif  // USE_SENSOR
 #ifdef USE_TEXT_SENSOR
   if ((this->precipitation_intensity_text_sensor_ != nullptr) && (precipitation_intensity_updated)) {
-    this->precipitation_intensity_text_sensor_->publish_state(precipitation_to_description(precipitation_intensity));
+    this->precipitation_intensity_text_sensor_->publish_state(
+        precipitation_to_description(precipitation_intensity));
   }
 #endif  // USE_TEXT_SENSOR
-  unsigned int uv_intensity_val = data[11] + (((uint16_t) data[10]) << 8);
-  float uv_intensity = (uv_intensity_val != 0xFFFF) ? uv_intensity_val / 10.0 : NAN;
+  float uv_intensity = frame.get_uv_intensity();
 #ifdef USE_SENSOR
   if (this->uv_intensity_sensor_ != nullptr) {
     this->uv_intensity_sensor_->publish_state(uv_intensity);
   }
-  if (this->uv_index_sensor_ != nullptr) {
-    if (!std::isnan(uv_intensity)) {
-      uint8_t uv_index = uv_intensity_val / 400;
-      this->uv_index_sensor_->publish_state(uv_index);
-    } else {
-      this->uv_index_sensor_->publish_state(NAN);
-    }
+  if ((this->uv_index_sensor_ != nullptr) && (changed_fields & UV_INDEX_INPUTS)) {
+    this->uv_index_sensor_->publish_state(frame.get_uv_index());
   }
 #endif  // USE_SENSOR
 #ifdef USE_BINARY_SENSOR
-  if ((this->night_binary_sensor_ != nullptr) && !std::isnan(uv_intensity)) {
-    bool night = detect_night(uv_intensity, this->lower_night_threshold_, this->upper_night_threshold_);
-    this->night_binary_sensor_->publish_state(night);
+  if ((this->night_binary_sensor_ != nullptr) && !std::isnan(uv_intensity) && (changed_fields & NIGHT_INPUTS)) {
+    this->night_binary_sensor_->publish_state(this->detect_night_(uv_intensity));
   }
 #endif  // USE_BINARY_SENSOR
-  uint32_t light_val = (data[14] + (data[13] << 8) + (data[12] << 16));
-  float light = (light_val != 0xFFFFFF) ? light_val / 10.0 : NAN;
+  float light = frame.get_light();
 #ifdef USE_SENSOR
   if (this->light_sensor_ != nullptr) {
     this->light_sensor_->publish_state(light);
   }
 #endif  // USE_SENSOR
 #ifdef USE_TEXT_SENSOR
-  if (this->light_text_sensor_ != nullptr) {
-    uint32_t light = (data[14] + (data[13] << 8) + (data[12] << 16));
-    if (light != 0xFFFFFF) {
-      this->light_text_sensor_->publish_state(light_level_to_description(light / 10.0));
+  if ((this->light_text_sensor_ != nullptr) && (changed_fields & LIGHT_TEXT_INPUTS)) {
+    if (frame.light != LIGHT_NOT_AVAILABLE) {
+      this->light_text_sensor_->publish_state(light_level_to_description(light));
     } else {
       this->light_text_sensor_->publish_state("Unknown");
     }
   }
+  if ((this->weather_conditions_text_sensor_ != nullptr) && (changed_fields & WEATHER_CONDITIONS_INPUTS)) {
+    this->weather_conditions_text_sensor_->publish_state(
+        get_weather_condition(temperature, precipitation_intensity, wind_speed, light, humidity));
+  }
 #endif  // USE_TEXT_SENSOR
+}
+
+#ifdef USE_BINARY_SENSOR
+bool WeatherStation::detect_night_(float uv_intensity) {
+  if (!this->night_.has_value()) {
+    this->night_ = uv_intensity < ((this->lower_night_threshold_ + this->upper_night_threshold_) / 2.0f);
+  } else {
+    this->night_ = this->night_.value() ? (uv_intensity < this->upper_night_threshold_)
+                                        : (uv_intensity < this->lower_night_threshold_);
+  }
+  return this->night_.value();
+}
+
+void WeatherStation::set_upper_night_threshold(float upper_night_threshold) {
+  this->upper_night_threshold_ = upper_night_threshold;
+  this->forced_inputs_ |= NIGHT_INPUTS;
+}
+
+void WeatherStation::set_lower_night_threshold(float lower_night_threshold) {
+  this->lower_night_threshold_ = lower_night_threshold;
+  this->forced_inputs_ |= NIGHT_INPUTS;
+}
+#endif  // USE_BINARY_SENSOR
+
+#ifdef USE_TEXT_SENSOR
+void WeatherStation::set_north_correction(int north_correction) {
+  this->north_correction_ = north_correction;
+  this->compass_lut_dirty_ = true;
+  this->forced_inputs_ |= WIND_DIRECTION_TEXT_INPUTS;
+}
+
+void WeatherStation::set_secondary_intercardinal_direction(bool three_letter_direction) {
+  this->secondary_intercardinal_direction_ = three_letter_direction;
+  this->compass_lut_dirty_ = true;
+  this->forced_inputs_ |= WIND_DIRECTION_TEXT_INPUTS;
+}
+
+void WeatherStation::rebuild_compass_lut_() {
+  // 16 points are 22.5 degrees apart, 8 points use every second direction
+  int step = this->secondary_intercardinal_direction_ ? 1 : 2;
+  int points = 16 / step;
+  for (int angle = 0; angle < 360; angle++) {
+    int corrected = ((angle + this->north_correction_) % 360 + 360) % 360;
+    // (angle + sector / 2) / sector with sectors of 360 / points degrees centered on their direction
+    int sector = ((corrected * 16 * points + 360 * 8) / (360 * 16)) % points;
+    this->compass_lut_[angle] = sector * step;
+  }
+  this->compass_lut_dirty_ = false;
+}
+#endif  // USE_TEXT_SENSOR
+
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+const std::string &WeatherStation::get_mqtt_frame_topic() {
+  if (this->mqtt_frame_topic_.empty())
+    this->mqtt_frame_topic_ = mqtt::global_mqtt_client->get_topic_prefix() + "/frame";
+  return this->mqtt_frame_topic_;
+}
+
+void WeatherStation::publish_mqtt_frame_(const DecodedFrame &frame) {
+  if ((mqtt::global_mqtt_client == nullptr) || !mqtt::global_mqtt_client->is_connected())
+    return;
+  size_t length = serialize_frame(this->mqtt_frame_format_, frame, this->get_precipitation_intensity(),
+                                  this->frame_message_, sizeof(this->frame_message_));
+  if (length == 0) {
+    ESP_LOGW(TAG, "Frame message does not fit into %u bytes", (unsigned) sizeof(this->frame_message_));
+    return;
+  }
+  mqtt::global_mqtt_client->publish(this->get_mqtt_frame_topic(), reinterpret_cast<const char *>(this->frame_message_),
+                                    length, this->mqtt_frame_qos_, this->mqtt_frame_retain_);
+}
+#endif  // USE_MISOL_WEATHER_MQTT_FRAME
+
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+void WeatherStation::send_influxdb_frame_(const DecodedFrame &frame) {
+  if (!network::is_connected())
+    return;
+  size_t length = serialize_frame(FrameFormat::LINE_PROTOCOL, frame, this->get_precipitation_intensity(),
+                                  this->frame_message_, sizeof(this->frame_message_), this->influxdb_prefix_.c_str());
+  if (length == 0) {
+    ESP_LOGW(TAG, "Line protocol message does not fit into %u bytes", (unsigned) sizeof(this->frame_message_));
+    return;
+  }
+  if (!this->influxdb_sender_.send(this->frame_message_, length))
+    ESP_LOGV(TAG, "Line protocol message was not sent");
+}
+#endif  // USE_MISOL_WEATHER_INFLUXDB
+
+float WeatherStation::get_precipitation_intensity() const {
+#if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
+  return this->precipitation_window_.get_intensity();
+#else
+  return NAN;
+#endif
+}
+
+void WeatherStation::set_setting(Setting setting, float value) {
+  ESP_LOGD(TAG, "Setting %u changed to %.1f", setting, value);
+  switch (setting) {
+#ifdef USE_BINARY_SENSOR
+    case SETTING_UPPER_NIGHT_THRESHOLD:
+      this->set_upper_night_threshold(value);
+      if (this->lower_night_threshold_ > value) {
+        this->set_lower_night_threshold(value);
+        this->setting_callback_.call(SETTING_LOWER_NIGHT_THRESHOLD, value);
+      }
+      break;
+    case SETTING_LOWER_NIGHT_THRESHOLD:
+      this->set_lower_night_threshold(value);
+      if (this->upper_night_threshold_ < value) {
+        this->set_upper_night_threshold(value);
+        this->setting_callback_.call(SETTING_UPPER_NIGHT_THRESHOLD, value);
+      }
+      break;
+#endif  // USE_BINARY_SENSOR
 #ifdef USE_TEXT_SENSOR
-  if (this->weather_conditions_text_sensor_ != nullptr) {
-    this->weather_conditions_text_sensor_->publish_state(get_weather_condition(temperature, precipitation_intensity, wind_speed, light, humidity));
+    case SETTING_NORTH_CORRECTION:
+      this->set_north_correction(lroundf(value));
+      break;
+    case SETTING_COMPASS_POINTS:
+      this->set_secondary_intercardinal_direction(value > 8);
+      break;
+#endif  // USE_TEXT_SENSOR
+#if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
+    case SETTING_PRECIPITATION_INTENSITY_INTERVAL:
+      this->set_precipitation_intensity_interval(lroundf(value));
+      break;
+#endif  // USE_SENSOR || USE_TEXT_SENSOR
+    default:
+      break;
   }
 }
+
+float WeatherStation::get_setting(Setting setting) const {
+  switch (setting) {
+#ifdef USE_BINARY_SENSOR
+    case SETTING_UPPER_NIGHT_THRESHOLD:
+      return this->upper_night_threshold_;
+    case SETTING_LOWER_NIGHT_THRESHOLD:
+      return this->lower_night_threshold_;
+#endif  // USE_BINARY_SENSOR
+#ifdef USE_TEXT_SENSOR
+    case SETTING_NORTH_CORRECTION:
+      return this->north_correction_;
+    case SETTING_COMPASS_POINTS:
+      return this->secondary_intercardinal_direction_ ? 16 : 8;
 #endif  // USE_TEXT_SENSOR
+#if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
+    case SETTING_PRECIPITATION_INTENSITY_INTERVAL:
+      return this->precipitation_window_.get_interval() / (60 * 1000);
+#endif  // USE_SENSOR || USE_TEXT_SENSOR
+    default:
+      return NAN;
+  }
+}
+
+void WeatherStation::dump_frames() {
+  if (!this->flight_recorder_.is_enabled()) {
+    ESP_LOGW(TAG, "Flight recorder is disabled");
+    return;
+  }
+  uint32_t now = to_milliseconds(std::chrono::steady_clock::now());
+  ESP_LOGI(TAG, "Flight recorder, %u frames:", this->flight_recorder_.size());
+  for (uint8_t i = 0; i < this->flight_recorder_.size(); i++) {
+    const RecordedFrame &frame = this->flight_recorder_.get(i);
+    ESP_LOGI(TAG, "  %u ms ago, %s: %s", (unsigned) (now - frame.timestamp_ms), frame_result_to_string(frame.result),
+             format_hex_pretty(frame.data, frame.length).c_str());
+  }
+}
+
+void WeatherStation::dump_profile(bool reset) {
+#ifdef USE_MISOL_WEATHER_PROFILING
+  static const char *const SECTION_NAMES[PROFILE_SECTION_COUNT] = {"loop()", "check_packet_()", "process_packet_()",
+                                                                   "publish"};
+  float ticks_per_us = get_profiler_ticks_per_us();
+  for (uint8_t section = 0; section < PROFILE_SECTION_COUNT; section++) {
+    const LatencyHistogram &histogram = this->histograms_[section];
+    ESP_LOGI(TAG, "%s: %u calls, p50 %.1f us, p99 %.1f us, max %.1f us", SECTION_NAMES[section],
+             (unsigned) histogram.get_count(), histogram.get_percentile(50) / ticks_per_us,
+             histogram.get_percentile(99) / ticks_per_us, histogram.get_max() / ticks_per_us);
+    for (uint8_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; bucket++) {
+      if (histogram.get_bucket(bucket) > 0) {
+        ESP_LOGI(TAG, "  < %.1f us: %u", ((uint64_t) 1 << bucket) / ticks_per_us,
+                 (unsigned) histogram.get_bucket(bucket));
+      }
+    }
+    if (reset)
+      this->histograms_[section].reset();
+  }
+#else
+  ESP_LOGW(TAG, "Profiling is disabled");
+#endif  // USE_MISOL_WEATHER_PROFILING
+}
+
 }  // namespace misol_weather
 }  // namespace esphome
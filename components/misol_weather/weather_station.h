@@ -1,8 +1,27 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/uart/uart.h"
+#include "battery_monitor.h"
+#include "cadence_tracker.h"
+#include "decoded_frame.h"
+#include "edge_detector.h"
+#include "fault_detector.h"
+#include "flight_recorder.h"
+#include "frame_filter.h"
+#include "frame_scanner.h"
+#include "frame_serializer.h"
+#include "intensity_window.h"
+#include "memory_probe.h"
+#include "profiler.h"
+#include "spsc_ring.h"
+#include "udp_sender.h"
+#include "wall_clock.h"
 #ifdef USE_SENSOR
 #include "esphome/components/sensor/sensor.h"
 #endif
@@ -12,14 +31,53 @@
 #ifdef USE_TEXT_SENSOR
 #include "esphome/components/text_sensor/text_sensor.h"
 #endif
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+#include "esphome/components/mqtt/mqtt_client.h"
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+#include "esphome/components/network/util.h"
+#endif
+#ifdef USE_MISOL_WEATHER_TASK
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+#ifdef USE_MISOL_WEATHER_DMA
+#include <hardware/uart.h>
+#include <pico/time.h>
+#endif
+#ifdef USE_MISOL_WEATHER_UART_EVENT
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#endif
 
 namespace esphome {
 namespace misol_weather {
 
-enum class PacketType {
-  WRONG_PACKET = -1,
-  BASIC_PACKET = 0,
-  BASIC_WITH_PRESSURE,
+static const size_t RX_BUFFER_SIZE = 64;
+// Idle line time after which everything received belongs to finished frames
+static constexpr std::chrono::milliseconds FRAME_IDLE_GAP{100};
+
+struct LinkStatistics {
+  uint32_t frames_ok{0};
+  uint32_t checksum_failures{0};
+  uint32_t pressure_failures{0};
+  uint32_t resyncs{0};
+  uint32_t bytes_discarded{0};
+};
+
+// Settings that can be changed at runtime, e.g. by number entities
+enum Setting : uint8_t {
+  SETTING_UPPER_NIGHT_THRESHOLD = 0,
+  SETTING_LOWER_NIGHT_THRESHOLD,
+  SETTING_NORTH_CORRECTION,
+  SETTING_PRECIPITATION_INTENSITY_INTERVAL,
+  // 8 or 16 points of the wind direction text
+  SETTING_COMPASS_POINTS,
 };
 
 class WeatherStation : public Component, public uart::UARTDevice {
@@ -35,12 +93,37 @@ class WeatherStation : public Component, public uart::UARTDevice {
   SUB_SENSOR(uv_index)
   SUB_SENSOR(light)
   SUB_SENSOR(precipitation_intensity)
+  SUB_SENSOR(frames_ok)
+  SUB_SENSOR(checksum_failures)
+  SUB_SENSOR(pressure_failures)
+  SUB_SENSOR(resyncs)
+  SUB_SENSOR(bytes_discarded)
+  SUB_SENSOR(frames_per_hour)
+  SUB_SENSOR(missed_transmissions)
+  SUB_SENSOR(link_quality)
+  SUB_SENSOR(inter_arrival_jitter)
+  SUB_SENSOR(filter_rejections)
+  SUB_SENSOR(degraded_fields)
+  SUB_SENSOR(battery_low_ratio)
+  SUB_SENSOR(battery_days_to_failure)
+  SUB_SENSOR(queue_high_water)
+  SUB_SENSOR(queue_overflows)
+  SUB_SENSOR(clock_drift)
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+  SUB_SENSOR(min_free_heap)
+  SUB_SENSOR(min_largest_free_block)
+  SUB_SENSOR(min_stack_headroom)
+#endif
 #endif
 #ifdef USE_BINARY_SENSOR
   SUB_BINARY_SENSOR(battery_level)
   SUB_BINARY_SENSOR(night)
-  void set_upper_night_threshold(float upper_night_threshold) { this->upper_night_threshold_ = upper_night_threshold; };
-  void set_lower_night_threshold(float lower_night_threshold) { this->lower_night_threshold_ = lower_night_threshold; };
+  void set_fault_binary_sensor(Field field, binary_sensor::BinarySensor *binary_sensor, uint32_t flat_line_duration,
+                               float min_value, float max_value) {
+    this->field_faults_[field] = std::make_unique<FieldFault>(binary_sensor, flat_line_duration, min_value, max_value);
+  }
+  void set_upper_night_threshold(float upper_night_threshold);
+  void set_lower_night_threshold(float lower_night_threshold);
 #endif
 #ifdef USE_TEXT_SENSOR
   SUB_TEXT_SENSOR(wind_direction)
@@ -48,37 +131,284 @@ class WeatherStation : public Component, public uart::UARTDevice {
   SUB_TEXT_SENSOR(light)
   SUB_TEXT_SENSOR(precipitation_intensity)
   SUB_TEXT_SENSOR(weather_conditions)
-  void set_north_correction(int north_correction) { this->north_correction_ = north_correction; };
-  void set_secondary_intercardinal_direction(bool three_letter_direction) { this->secondary_intercardinal_direction_ = three_letter_direction; };
+  void set_north_correction(int north_correction);
+  void set_secondary_intercardinal_direction(bool three_letter_direction);
 #endif
 #if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
   void set_precipitation_intensity_interval(unsigned int precipitation_intensity_interval) {
-    this->precipitation_intensity_interval_ = std::chrono::minutes(precipitation_intensity_interval);
+    this->precipitation_window_.set_interval(precipitation_intensity_interval * 60 * 1000);
   }
 #endif  // USE_SENSOR || USE_TEXT_SENSOR
  public:
   float get_setup_priority() const override { return setup_priority::HARDWARE; }
+  void setup() override;
   void loop() override;
+  const LinkStatistics &get_link_statistics() const { return this->link_statistics_; }
+  // Settings of platforms that are not used are ignored, their value is NAN. A night threshold set past the other
+  // one moves the other one along, so the band is never inverted.
+  void set_setting(Setting setting, float value);
+  float get_setting(Setting setting) const;
+  // Called when set_setting() changed a setting other than the one it was called for
+  void add_on_setting_callback(std::function<void(Setting, float)> &&callback) {
+    this->setting_callback_.add(std::move(callback));
+  }
+  const CadenceTracker &get_cadence_tracker() const { return this->cadence_tracker_; }
+  void set_communication_timeout(uint32_t communication_timeout) {
+    this->communication_timeout_ = std::chrono::milliseconds(communication_timeout);
+  }
+  void set_timeout_periods(uint8_t timeout_periods) { this->timeout_periods_ = timeout_periods; }
+  void set_outlier_filter(OutlierFilterMethod method, uint8_t window_size, float threshold) {
+    this->frame_filter_ = std::make_unique<FrameFilter>(method, window_size, threshold);
+  }
+  void enable_outlier_filter_field(Field field) { this->frame_filter_->enable_field(field); }
+  void set_flight_recorder_size(uint8_t size) {
+#ifdef USE_MISOL_WEATHER_HISTORY
+    // The history serves the filtered values and the final quality flags
+    this->flight_recorder_.init(size, true);
+#else
+    this->flight_recorder_.init(size);
+#endif
+  }
+#ifdef USE_TIME
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+  // prefix is the measurement with the tags, already escaped
+  void set_influxdb(const std::string &address, uint16_t port, const std::string &prefix) {
+    this->influxdb_address_ = address;
+    this->influxdb_port_ = port;
+    this->influxdb_prefix_ = prefix;
+  }
+#endif
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+  // An empty topic publishes to <topic_prefix>/frame. Without entity_states the sensors in the frame do not publish
+  // their states over MQTT (see FrameMQTTSensor).
+  void set_mqtt_frame(const std::string &topic, FrameFormat format, uint8_t qos, bool retain, bool entity_states) {
+    this->mqtt_frame_topic_ = topic;
+    this->mqtt_frame_format_ = format;
+    this->mqtt_frame_qos_ = qos;
+    this->mqtt_frame_retain_ = retain;
+    this->mqtt_frame_entity_states_ = entity_states;
+  }
+  bool get_mqtt_frame_entity_states() const { return this->mqtt_frame_entity_states_; }
+  // The topic prefix is only known once the MQTT client is set up
+  const std::string &get_mqtt_frame_topic();
+#endif
+  const WallClock &get_wall_clock() const { return this->wall_clock_; }
+  void set_battery_dwell_time(uint32_t dwell_time) { this->battery_monitor_.set_dwell_time(dwell_time); }
+  const BatteryMonitor &get_battery_monitor() const { return this->battery_monitor_; }
+  const FlightRecorder &get_flight_recorder() const { return this->flight_recorder_; }
+  // Copy of the last decoded frame, false before the first one
+  bool get_last_frame(DecodedFrame &frame) const {
+    frame = this->previous_frame_;
+    return this->has_previous_frame_;
+  }
+  float get_precipitation_intensity() const;
+#if defined(USE_MISOL_WEATHER_METRICS) || defined(USE_MISOL_WEATHER_HISTORY)
+  // Held by loop() while it changes the state, the web server runs in its own task on ESP-IDF and takes it to read
+  // the last frame, the link statistics and the flight recorder
+  Mutex &get_state_lock() { return this->state_lock_; }
+#endif
+  // Called once per decoded frame after it was published, timestamp_ms is the arrival of its first byte
+  void add_on_frame_callback(std::function<void(const DecodedFrame &, uint32_t)> &&callback) {
+    this->frame_callback_.add(std::move(callback));
+  }
+  // One detector for on_rain_start and on_rain_stop, so both see the same rain events
+  void set_rain_dry_time(uint32_t dry_time) { this->rain_detector_ = RainDetector(dry_time); }
+  // Called with true when it starts raining and false when it stops, after the frame callbacks
+  void add_on_rain_callback(std::function<void(bool)> &&callback) { this->rain_callback_.add(std::move(callback)); }
+  void dump_frames();
+  void dump_profile(bool reset);
+#if defined(USE_MISOL_WEATHER_PROFILING) && defined(USE_SENSOR)
+  void set_profile_sensor(ProfileSection section, ProfileStatistic statistic, sensor::Sensor *sensor) {
+    this->profile_sensors_[section][statistic] = sensor;
+  }
+#endif
 
  protected:
+  void read_rx_data_(size_t size, const std::chrono::steady_clock::time_point &now);
+  // Estimates the arrival time of the first buffered byte from the time the last one was seen
+  void update_rx_start_time_(const std::chrono::steady_clock::time_point &last_byte_time, size_t new_bytes);
+  // Frames are time stamped with the arrival of their first byte
+  void parse_rx_buffer_(bool flush);
+  // Hands a frame found by the parser to handle_frame_(), through the frame queue when the receive task is used
+  void dispatch_frame_(const uint8_t *data, size_t len, FrameResult result,
+                       const std::chrono::steady_clock::time_point &now);
+  void handle_frame_(const uint8_t *data, size_t len, FrameResult result,
+                     const std::chrono::steady_clock::time_point &now);
+  void discard_rx_bytes_(size_t count, bool in_sync);
+  void update_diagnostics_();
   PacketType check_packet_(const uint8_t *data, size_t len);
   void process_packet_(const uint8_t *data, size_t len, bool has_pressure,
                        const std::chrono::steady_clock::time_point &now);
-  void reset_sub_entities_();
+  // changed_fields: fields (1 << Field) that differ from the previous frame, derived outputs of other
+  // fields are not recomputed
+  void publish_frame_(const DecodedFrame &frame, uint16_t changed_fields,
+                      const std::chrono::steady_clock::time_point &now);
+#ifdef USE_BINARY_SENSOR
+  bool detect_night_(float uv_intensity);
+#endif
+#ifdef USE_TEXT_SENSOR
+  void rebuild_compass_lut_();
+#endif
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+  void publish_mqtt_frame_(const DecodedFrame &frame);
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+  void send_influxdb_frame_(const DecodedFrame &frame);
+#endif
+  std::chrono::milliseconds get_communication_timeout_() const;
+  // Returns the mask of fields that are stale and missing in the frame
+  uint16_t update_field_freshness_(const DecodedFrame &frame, const std::chrono::steady_clock::time_point &now);
+  void check_stale_fields_(const std::chrono::steady_clock::time_point &now);
+#ifdef USE_TIME
+  void update_wall_clock_(const std::chrono::steady_clock::time_point &now);
+#endif
+  // Runs the diagnostics update on wall clock minute boundaries
+  void schedule_aligned_diagnostics_();
+  void reset_field_entities_(Field field);
+  void update_fault_detectors_(DecodedFrame &frame, uint16_t changed_fields,
+                               const std::chrono::steady_clock::time_point &now);
+#ifdef USE_MISOL_WEATHER_UART_EVENT
+  // Reinstalls the UART driver with an event queue and RX timeout, returns false to keep polling
+  bool setup_uart_events_();
+  void process_uart_events_(const std::chrono::steady_clock::time_point &now);
+  QueueHandle_t uart_event_queue_{nullptr};
+  uart_port_t uart_port_{};
+#endif  // USE_MISOL_WEATHER_UART_EVENT
+#ifdef USE_MISOL_WEATHER_TASK
+  struct FrameRecord {
+    std::chrono::steady_clock::time_point timestamp;
+    FrameResult result;
+    uint8_t length;
+    uint8_t data[PRESSURE_PACKET_SIZE];
+  };
+  static const size_t FRAME_QUEUE_SIZE = 8;
+  // Starts the receive task, returns false to keep polling in loop()
+  bool start_rx_task_();
+  static void rx_task_(void *arg);
+  void process_frame_queue_();
+  TaskHandle_t rx_task_handle_{nullptr};
+  SpscRing<FrameRecord, FRAME_QUEUE_SIZE> frame_queue_;
+  // Discarded bytes counted by the receive task, moved into link_statistics_ by the main loop
+  std::atomic<uint32_t> task_resyncs_{0};
+  std::atomic<uint32_t> task_bytes_discarded_{0};
+#endif  // USE_MISOL_WEATHER_TASK
+#ifdef USE_MISOL_WEATHER_DMA
+  // Power of two, the DMA write address wraps inside a buffer aligned to its size
+  static const uint32_t DMA_RING_BITS = 8;
+  static const uint32_t DMA_RING_SIZE = 1 << DMA_RING_BITS;
+  // Takes the hardware UART over from the UART component, returns false to keep polling
+  bool start_dma_();
+  static bool dma_timer_callback_(repeating_timer_t *timer);
+  void process_dma_ring_(const std::chrono::steady_clock::time_point &now);
+  void copy_dma_data_(uint32_t until, const std::chrono::steady_clock::time_point &now);
+  // Allocated with twice the ring size, the ring is the part aligned to its size. An over-aligned member would
+  // depend on aligned new for the component, which is allocated on the heap.
+  std::unique_ptr<uint8_t[]> dma_ring_storage_;
+  uint8_t *dma_ring_{nullptr};
+  int dma_channel_{-1};
+  repeating_timer_t dma_timer_;
+  // Written by the timer interrupt: free running count of received bytes, the count and time of the
+  // last byte before the most recent idle gap
+  volatile uint32_t dma_position_{0};
+  volatile uint32_t dma_received_{0};
+  volatile uint32_t dma_last_byte_us_{0};
+  volatile uint32_t dma_frame_end_{0};
+  volatile uint32_t dma_frame_end_us_{0};
+  // Main loop side
+  uint32_t dma_read_{0};
+  uint32_t dma_handled_frame_end_{0};
+#endif  // USE_MISOL_WEATHER_DMA
   bool first_data_received_{false};
   std::chrono::steady_clock::time_point last_packet_time_;
+  esphome::optional<std::chrono::milliseconds> communication_timeout_{};
+  uint8_t timeout_periods_{8};
+  // Time of the last valid value of every field, fields without a recent value are stale
+  std::chrono::steady_clock::time_point field_updated_[FIELD_COUNT];
+  uint16_t fresh_fields_{0};
+  uint8_t rx_buffer_[RX_BUFFER_SIZE];
+  size_t rx_length_{0};
+  std::chrono::steady_clock::time_point rx_start_time_;
+  std::chrono::microseconds character_time_{1042};
+  LinkStatistics link_statistics_;
+  // Valid frames per minute over the last hour, used for the frames per hour rate
+  uint16_t frames_per_minute_[60]{};
+  uint8_t frames_per_minute_index_{0};
+  uint8_t frames_per_minute_filled_{0};
+  uint32_t frames_ok_at_last_update_{0};
+  CadenceTracker cadence_tracker_;
+  BatteryMonitor battery_monitor_;
+  FlightRecorder flight_recorder_;
+  std::unique_ptr<FrameFilter> frame_filter_;
+  WallClock wall_clock_;
+  CallbackManager<void(const DecodedFrame &, uint32_t)> frame_callback_;
+  RainDetector rain_detector_{30 * 60 * 1000};
+  CallbackManager<void(bool)> rain_callback_;
+  CallbackManager<void(Setting, float)> setting_callback_;
+#if defined(USE_MISOL_WEATHER_METRICS) || defined(USE_MISOL_WEATHER_HISTORY)
+  Mutex state_lock_;
+#endif
+#ifdef USE_MISOL_WEATHER_MQTT_FRAME
+  std::string mqtt_frame_topic_;
+  FrameFormat mqtt_frame_format_{FrameFormat::JSON};
+  uint8_t mqtt_frame_qos_{0};
+  bool mqtt_frame_retain_{false};
+  bool mqtt_frame_entity_states_{true};
+#endif
+#ifdef USE_MISOL_WEATHER_INFLUXDB
+  std::string influxdb_address_;
+  uint16_t influxdb_port_{8089};
+  std::string influxdb_prefix_;
+  UdpSender influxdb_sender_;
+#endif
+#if defined(USE_MISOL_WEATHER_MQTT_FRAME) || defined(USE_MISOL_WEATHER_INFLUXDB)
+  // Reused for every frame and output, messages are built in place and handed to the network stack
+  uint8_t frame_message_[MAX_FRAME_MESSAGE_SIZE];
+#endif
+#ifdef USE_TIME
+  time::RealTimeClock *time_{nullptr};
+  uint32_t last_clock_sync_ms_{0};
+  // Second of the reference clock while waiting for the next one to start, 0 when not waiting
+  time_t clock_second_{0};
+#endif
+  DecodedFrame previous_frame_;
+  // Inputs of derived outputs to recompute with the next frame regardless of changes
+  uint16_t forced_inputs_{0};
+  bool has_previous_frame_{false};
+#ifdef USE_BINARY_SENSOR
+  struct FieldFault {
+    FieldFault(binary_sensor::BinarySensor *binary_sensor, uint32_t flat_line_duration, float min_value,
+               float max_value)
+        : binary_sensor(binary_sensor), detector(flat_line_duration, min_value, max_value) {}
+    binary_sensor::BinarySensor *binary_sensor;
+    FaultDetector detector;
+  };
+  std::unique_ptr<FieldFault> field_faults_[FIELD_COUNT];
+#endif  // USE_BINARY_SENSOR
+#ifdef USE_MISOL_WEATHER_MEMORY_WATERMARKS
+  MemoryWatermarks memory_watermarks_;
+#endif
+#ifdef USE_MISOL_WEATHER_PROFILING
+  LatencyHistogram histograms_[PROFILE_SECTION_COUNT];
+#ifdef USE_SENSOR
+  sensor::Sensor *profile_sensors_[PROFILE_SECTION_COUNT][PROFILE_STATISTIC_COUNT]{};
+#endif
+#endif  // USE_MISOL_WEATHER_PROFILING
 #if defined(USE_SENSOR) || defined(USE_TEXT_SENSOR)
-  std::chrono::milliseconds precipitation_intensity_interval_{std::chrono::minutes(5)};
-  std::chrono::steady_clock::time_point previous_precipitation_timestamp_;
-  esphome::optional<uint16_t> previous_precipitation_{};
+  IntensityWindow precipitation_window_{5 * 60 * 1000};
 #endif  // USE_SENSOR || USE_TEXT_SENSOR
 #ifdef USE_TEXT_SENSOR
   int north_correction_{0};
   bool secondary_intercardinal_direction_{false};
+  // Index into the compass directions for every raw wind direction, rebuilt when the settings change
+  uint8_t compass_lut_[360]{};
+  bool compass_lut_dirty_{true};
 #endif
 #ifdef USE_BINARY_SENSOR
   float upper_night_threshold_{5.5};
   float lower_night_threshold_{4.5};
+  esphome::optional<bool> night_{};
 #endif // USE_BINARY_SENSOR
 };
 
@@ -0,0 +1,149 @@
+#include "batch_decoder.h"
+#include "decoded_frame.h"
+#include "frame_scanner.h"
+
+namespace misol_decode {
+
+using namespace esphome::misol_weather;
+
+void FrameColumns::resize(size_t count) {
+  this->packet_type.resize(count);
+  this->wind_direction.resize(count);
+  this->low_battery.resize(count);
+  this->temperature.resize(count);
+  this->humidity.resize(count);
+  this->wind_speed.resize(count);
+  this->wind_gust.resize(count);
+  this->precipitation.resize(count);
+  this->uv_intensity.resize(count);
+  this->light.resize(count);
+  this->pressure.resize(count);
+}
+
+const char *batch_kernel_to_string(BatchKernel kernel) {
+  switch (kernel) {
+    case BatchKernel::SCALAR:
+      return "scalar";
+    case BatchKernel::SSE2:
+      return "sse2";
+    case BatchKernel::AVX2:
+      return "avx2";
+    case BatchKernel::NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+bool is_batch_kernel_supported(BatchKernel kernel) {
+  switch (kernel) {
+    case BatchKernel::SCALAR:
+      return true;
+#ifdef MISOL_DECODE_SSE2
+    case BatchKernel::SSE2:
+      return true;
+#endif
+#ifdef MISOL_DECODE_AVX2
+    case BatchKernel::AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+#ifdef MISOL_DECODE_NEON
+    case BatchKernel::NEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+BatchKernel get_best_batch_kernel() {
+  for (BatchKernel kernel : {BatchKernel::AVX2, BatchKernel::NEON, BatchKernel::SSE2}) {
+    if (is_batch_kernel_supported(kernel))
+      return kernel;
+  }
+  return BatchKernel::SCALAR;
+}
+
+namespace {
+
+// The component functions, the reference for the vector kernels
+void decode_scalar(const uint8_t *data, size_t size, uint64_t offset, const ColumnPointers &out, size_t index) {
+  const uint8_t *frame_data = data + offset;
+  size_t length = size - offset;
+  PacketType packet_type = check_packet(frame_data, length);
+  DecodedFrame frame;
+  decode_frame(frame_data, length, packet_type == PacketType::BASIC_WITH_PRESSURE, frame);
+  out.packet_type[index] = (int8_t) packet_type;
+  out.wind_direction[index] = frame.wind_direction;
+  out.low_battery[index] = frame.low_battery;
+  out.temperature[index] = frame.temperature;
+  out.humidity[index] = frame.humidity;
+  out.wind_speed[index] = frame.wind_speed;
+  out.wind_gust[index] = frame.wind_gust;
+  out.precipitation[index] = frame.precipitation;
+  out.uv_intensity[index] = frame.uv_intensity;
+  out.light[index] = frame.light;
+  out.pressure[index] = frame.pressure;
+}
+
+ColumnPointers column_pointers(FrameColumns &columns, size_t index) {
+  return ColumnPointers{
+      columns.packet_type.data() + index,  columns.wind_direction.data() + index, columns.low_battery.data() + index,
+      columns.temperature.data() + index,  columns.humidity.data() + index,       columns.wind_speed.data() + index,
+      columns.wind_gust.data() + index,    columns.precipitation.data() + index,  columns.uv_intensity.data() + index,
+      columns.light.data() + index,        columns.pressure.data() + index,
+  };
+}
+
+}  // namespace
+
+void decode_batch(const uint8_t *data, size_t size, const uint64_t *offsets, size_t count, FrameColumns &columns,
+                  BatchKernel kernel) {
+  columns.resize(count);
+  void (*decode_block)(const uint8_t *, const uint64_t *, const ColumnPointers &) = nullptr;
+  size_t block_frames = 1;
+  if (is_batch_kernel_supported(kernel)) {
+    switch (kernel) {
+#ifdef MISOL_DECODE_SSE2
+      case BatchKernel::SSE2:
+        decode_block = decode_block_sse2;
+        block_frames = SSE2_BLOCK_FRAMES;
+        break;
+#endif
+#ifdef MISOL_DECODE_AVX2
+      case BatchKernel::AVX2:
+        decode_block = decode_block_avx2;
+        block_frames = AVX2_BLOCK_FRAMES;
+        break;
+#endif
+#ifdef MISOL_DECODE_NEON
+      case BatchKernel::NEON:
+        decode_block = decode_block_neon;
+        block_frames = NEON_BLOCK_FRAMES;
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+  ColumnPointers base = column_pointers(columns, 0);
+  size_t index = 0;
+  if (decode_block != nullptr) {
+    for (; index + block_frames <= count; index += block_frames) {
+      // The kernels load the bytes up to the pressure trailer of every frame
+      bool complete = true;
+      for (size_t i = index; i < index + block_frames; i++)
+        complete &= offsets[i] + PRESSURE_PACKET_SIZE <= size;
+      if (complete) {
+        decode_block(data, offsets + index, column_pointers(columns, index));
+      } else {
+        for (size_t i = index; i < index + block_frames; i++)
+          decode_scalar(data, size, offsets[i], base, i);
+      }
+    }
+  }
+  for (; index < count; index++)
+    decode_scalar(data, size, offsets[index], base, index);
+}
+
+}  // namespace misol_decode
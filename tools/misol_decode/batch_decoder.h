@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace misol_decode {
+
+// Frame fields as columns, one entry per frame, in the wire units of DecodedFrame
+struct FrameColumns {
+  std::vector<int8_t> packet_type;  // PacketType of check_packet()
+  std::vector<uint16_t> wind_direction;
+  std::vector<uint8_t> low_battery;
+  std::vector<uint16_t> temperature;
+  std::vector<uint8_t> humidity;
+  std::vector<uint16_t> wind_speed;
+  std::vector<uint8_t> wind_gust;
+  std::vector<uint16_t> precipitation;
+  std::vector<uint16_t> uv_intensity;
+  std::vector<uint32_t> light;
+  std::vector<uint32_t> pressure;  // 0 unless the pressure trailer is valid
+
+  void resize(size_t count);
+};
+
+// Column storage of a block of frames, so the kernels do not depend on std::vector
+struct ColumnPointers {
+  int8_t *packet_type;
+  uint16_t *wind_direction;
+  uint8_t *low_battery;
+  uint16_t *temperature;
+  uint8_t *humidity;
+  uint16_t *wind_speed;
+  uint8_t *wind_gust;
+  uint16_t *precipitation;
+  uint16_t *uv_intensity;
+  uint32_t *light;
+  uint32_t *pressure;
+};
+
+enum class BatchKernel : uint8_t {
+  SCALAR = 0,
+  SSE2,
+  AVX2,
+  NEON,
+};
+
+const char *batch_kernel_to_string(BatchKernel kernel);
+// Compiled in and supported by the CPU
+bool is_batch_kernel_supported(BatchKernel kernel);
+BatchKernel get_best_batch_kernel();
+
+// Validates and extracts the frames starting at offsets in data, like check_packet() and decode_frame() of the
+// component. Every frame needs at least BASIC_PACKET_SIZE bytes in data. The vector kernels transpose blocks of
+// 16 or 32 frames, so every byte position of the frames is a vector of all frames of the block, and validate and
+// extract them all at once; blocks with a frame closer than PRESSURE_PACKET_SIZE to the end of data and the
+// remaining frames use the scalar path. Fields of frames failing the checks are extracted as well.
+void decode_batch(const uint8_t *data, size_t size, const uint64_t *offsets, size_t count, FrameColumns &columns,
+                  BatchKernel kernel = get_best_batch_kernel());
+
+// Frames per block of the vector kernels, each decodes exactly one block
+static const size_t SSE2_BLOCK_FRAMES = 16;
+static const size_t AVX2_BLOCK_FRAMES = 32;
+static const size_t NEON_BLOCK_FRAMES = 16;
+void decode_block_sse2(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns);
+void decode_block_avx2(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns);
+void decode_block_neon(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns);
+
+}  // namespace misol_decode
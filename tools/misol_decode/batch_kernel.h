@@ -0,0 +1,75 @@
+#pragma once
+
+// Block decoder shared by the vector kernels, included by one translation unit per instruction set. Everything
+// has internal linkage: the translation units are compiled with different instruction set options, and an inline
+// function shared between them could end up running instructions the CPU does not have.
+
+#include <cstdint>
+#include "batch_decoder.h"
+
+namespace misol_decode {
+namespace {
+
+// Isa provides the vector type V with Isa::FRAMES byte lanes and:
+//   load(data, offsets, skip, rows): rows[i] = bytes skip..skip + 15 of the frames, frame f in lane f
+//   set1, add8, and_, or_, xor_, cmpeq8, unpacklo8, unpackhi8 (within 16 byte lanes like SSE)
+//   store8(pointer, v), store16(pointer, low_bytes, high_bytes), store32(pointer, b0, b1, b2, b3) in frame order
+template<typename Isa> struct BlockDecoder {
+  using V = typename Isa::V;
+
+  // Four rounds of interleaving rows i and i + 8 transpose 16 x 16 bytes: afterwards rows[j] holds byte j of
+  // every frame of the block
+  static void transpose(V *rows) {
+    V temp[16];
+    for (int round = 0; round < 4; round++) {
+      for (int i = 0; i < 8; i++) {
+        temp[2 * i] = Isa::unpacklo8(rows[i], rows[i + 8]);
+        temp[2 * i + 1] = Isa::unpackhi8(rows[i], rows[i + 8]);
+      }
+      for (int i = 0; i < 16; i++)
+        rows[i] = temp[i];
+    }
+  }
+
+  // 1 in the lanes with the bits of mask set, 0 in the others
+  static V bit(V value, uint8_t mask) {
+    V m = Isa::set1(mask);
+    return Isa::and_(Isa::cmpeq8(Isa::and_(value, m), m), Isa::set1(1));
+  }
+
+  static void decode(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &out) {
+    V b[16];
+    V t[16];
+    Isa::load(data, offsets, 0, b);
+    // Bytes 5 to 20, the checksum and the pressure trailer end up in t[11] to t[15]
+    Isa::load(data, offsets, 5, t);
+    transpose(b);
+    transpose(t);
+
+    V sum = b[0];
+    for (int i = 1; i < 16; i++)
+      sum = Isa::add8(sum, b[i]);
+    V basic = Isa::and_(Isa::cmpeq8(b[0], Isa::set1(0x24)), Isa::cmpeq8(sum, t[11]));
+    V pressure_sum = Isa::add8(Isa::add8(t[12], t[13]), t[14]);
+    V pressure = Isa::and_(basic, Isa::cmpeq8(pressure_sum, t[15]));
+    // WRONG_PACKET is -1, BASIC_PACKET 0 and BASIC_WITH_PRESSURE 1
+    Isa::store8(reinterpret_cast<uint8_t *>(out.packet_type),
+                Isa::or_(Isa::xor_(basic, Isa::set1(0xFF)), Isa::and_(pressure, Isa::set1(1))));
+
+    V zero = Isa::set1(0);
+    Isa::store16(out.wind_direction, b[2], bit(b[3], 0x80));
+    Isa::store8(out.low_battery, bit(b[3], 0x08));
+    Isa::store16(out.temperature, b[4], Isa::and_(b[3], Isa::set1(0x07)));
+    Isa::store8(out.humidity, b[5]);
+    Isa::store16(out.wind_speed, b[6], bit(b[3], 0x10));
+    Isa::store8(out.wind_gust, b[7]);
+    Isa::store16(out.precipitation, b[9], b[8]);
+    Isa::store16(out.uv_intensity, b[11], b[10]);
+    Isa::store32(out.light, b[14], b[13], b[12], zero);
+    Isa::store32(out.pressure, Isa::and_(t[14], pressure), Isa::and_(t[13], pressure), Isa::and_(t[12], pressure),
+                 zero);
+  }
+};
+
+}  // namespace
+}  // namespace misol_decode
@@ -0,0 +1,59 @@
+// Compiled with AVX2 enabled, only called after checking the CPU supports it
+#include "batch_kernel.h"
+#include <immintrin.h>
+
+namespace misol_decode {
+namespace {
+
+// Frames 0 to 15 in the low 16 byte lane, 16 to 31 in the high one. Unpacking works within the lanes, so the
+// transpose handles both halves at once and only widening to 16 and 32 bit needs to reorder the lanes.
+struct Avx2 {
+  using V = __m256i;
+  static const int FRAMES = 32;
+
+  static void load(const uint8_t *data, const uint64_t *offsets, int skip, V *rows) {
+    for (int i = 0; i < 16; i++) {
+      rows[i] = _mm256_loadu2_m128i(reinterpret_cast<const __m128i *>(data + offsets[i + 16] + skip),
+                                    reinterpret_cast<const __m128i *>(data + offsets[i] + skip));
+    }
+  }
+  static V set1(uint8_t value) { return _mm256_set1_epi8((char) value); }
+  static V add8(V a, V b) { return _mm256_add_epi8(a, b); }
+  static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+  static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+  static V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+  static V cmpeq8(V a, V b) { return _mm256_cmpeq_epi8(a, b); }
+  static V unpacklo8(V a, V b) { return _mm256_unpacklo_epi8(a, b); }
+  static V unpackhi8(V a, V b) { return _mm256_unpackhi_epi8(a, b); }
+  static void store8(uint8_t *pointer, V v) { _mm256_storeu_si256(reinterpret_cast<V *>(pointer), v); }
+  static void store16(uint16_t *pointer, V low, V high) {
+    // Frames 0-7 | 16-23 and 8-15 | 24-31
+    V lo = _mm256_unpacklo_epi8(low, high);
+    V hi = _mm256_unpackhi_epi8(low, high);
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  static void store32(uint32_t *pointer, V b0, V b1, V b2, V b3) {
+    V low_lo = _mm256_unpacklo_epi8(b0, b1);
+    V low_hi = _mm256_unpackhi_epi8(b0, b1);
+    V high_lo = _mm256_unpacklo_epi8(b2, b3);
+    V high_hi = _mm256_unpackhi_epi8(b2, b3);
+    // Frames 0-3 | 16-19, 4-7 | 20-23, 8-11 | 24-27 and 12-15 | 28-31
+    V q0 = _mm256_unpacklo_epi16(low_lo, high_lo);
+    V q1 = _mm256_unpackhi_epi16(low_lo, high_lo);
+    V q2 = _mm256_unpacklo_epi16(low_hi, high_hi);
+    V q3 = _mm256_unpackhi_epi16(low_hi, high_hi);
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer), _mm256_permute2x128_si256(q0, q1, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer + 8), _mm256_permute2x128_si256(q2, q3, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer + 16), _mm256_permute2x128_si256(q0, q1, 0x31));
+    _mm256_storeu_si256(reinterpret_cast<V *>(pointer + 24), _mm256_permute2x128_si256(q2, q3, 0x31));
+  }
+};
+
+}  // namespace
+
+void decode_block_avx2(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns) {
+  BlockDecoder<Avx2>::decode(data, offsets, columns);
+}
+
+}  // namespace misol_decode
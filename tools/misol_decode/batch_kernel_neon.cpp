@@ -0,0 +1,47 @@
+#include "batch_kernel.h"
+#include <arm_neon.h>
+
+namespace misol_decode {
+namespace {
+
+// Same layout as SSE2, zip1 and zip2 interleave like unpacklo and unpackhi
+struct Neon {
+  using V = uint8x16_t;
+  static const int FRAMES = 16;
+
+  static void load(const uint8_t *data, const uint64_t *offsets, int skip, V *rows) {
+    for (int i = 0; i < FRAMES; i++)
+      rows[i] = vld1q_u8(data + offsets[i] + skip);
+  }
+  static V set1(uint8_t value) { return vdupq_n_u8(value); }
+  static V add8(V a, V b) { return vaddq_u8(a, b); }
+  static V and_(V a, V b) { return vandq_u8(a, b); }
+  static V or_(V a, V b) { return vorrq_u8(a, b); }
+  static V xor_(V a, V b) { return veorq_u8(a, b); }
+  static V cmpeq8(V a, V b) { return vceqq_u8(a, b); }
+  static V unpacklo8(V a, V b) { return vzip1q_u8(a, b); }
+  static V unpackhi8(V a, V b) { return vzip2q_u8(a, b); }
+  static void store8(uint8_t *pointer, V v) { vst1q_u8(pointer, v); }
+  static void store16(uint16_t *pointer, V low, V high) {
+    vst1q_u8(reinterpret_cast<uint8_t *>(pointer), vzip1q_u8(low, high));
+    vst1q_u8(reinterpret_cast<uint8_t *>(pointer + 8), vzip2q_u8(low, high));
+  }
+  static void store32(uint32_t *pointer, V b0, V b1, V b2, V b3) {
+    uint16x8_t low_lo = vreinterpretq_u16_u8(vzip1q_u8(b0, b1));
+    uint16x8_t low_hi = vreinterpretq_u16_u8(vzip2q_u8(b0, b1));
+    uint16x8_t high_lo = vreinterpretq_u16_u8(vzip1q_u8(b2, b3));
+    uint16x8_t high_hi = vreinterpretq_u16_u8(vzip2q_u8(b2, b3));
+    vst1q_u16(reinterpret_cast<uint16_t *>(pointer), vzip1q_u16(low_lo, high_lo));
+    vst1q_u16(reinterpret_cast<uint16_t *>(pointer + 4), vzip2q_u16(low_lo, high_lo));
+    vst1q_u16(reinterpret_cast<uint16_t *>(pointer + 8), vzip1q_u16(low_hi, high_hi));
+    vst1q_u16(reinterpret_cast<uint16_t *>(pointer + 12), vzip2q_u16(low_hi, high_hi));
+  }
+};
+
+}  // namespace
+
+void decode_block_neon(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns) {
+  BlockDecoder<Neon>::decode(data, offsets, columns);
+}
+
+}  // namespace misol_decode
@@ -0,0 +1,46 @@
+#include "batch_kernel.h"
+#include <emmintrin.h>
+
+namespace misol_decode {
+namespace {
+
+struct Sse2 {
+  using V = __m128i;
+  static const int FRAMES = 16;
+
+  static void load(const uint8_t *data, const uint64_t *offsets, int skip, V *rows) {
+    for (int i = 0; i < FRAMES; i++)
+      rows[i] = _mm_loadu_si128(reinterpret_cast<const V *>(data + offsets[i] + skip));
+  }
+  static V set1(uint8_t value) { return _mm_set1_epi8((char) value); }
+  static V add8(V a, V b) { return _mm_add_epi8(a, b); }
+  static V and_(V a, V b) { return _mm_and_si128(a, b); }
+  static V or_(V a, V b) { return _mm_or_si128(a, b); }
+  static V xor_(V a, V b) { return _mm_xor_si128(a, b); }
+  static V cmpeq8(V a, V b) { return _mm_cmpeq_epi8(a, b); }
+  static V unpacklo8(V a, V b) { return _mm_unpacklo_epi8(a, b); }
+  static V unpackhi8(V a, V b) { return _mm_unpackhi_epi8(a, b); }
+  static void store8(uint8_t *pointer, V v) { _mm_storeu_si128(reinterpret_cast<V *>(pointer), v); }
+  static void store16(uint16_t *pointer, V low, V high) {
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer), _mm_unpacklo_epi8(low, high));
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer + 8), _mm_unpackhi_epi8(low, high));
+  }
+  static void store32(uint32_t *pointer, V b0, V b1, V b2, V b3) {
+    V low_lo = _mm_unpacklo_epi8(b0, b1);
+    V low_hi = _mm_unpackhi_epi8(b0, b1);
+    V high_lo = _mm_unpacklo_epi8(b2, b3);
+    V high_hi = _mm_unpackhi_epi8(b2, b3);
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer), _mm_unpacklo_epi16(low_lo, high_lo));
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer + 4), _mm_unpackhi_epi16(low_lo, high_lo));
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer + 8), _mm_unpacklo_epi16(low_hi, high_hi));
+    _mm_storeu_si128(reinterpret_cast<V *>(pointer + 12), _mm_unpackhi_epi16(low_hi, high_hi));
+  }
+};
+
+}  // namespace
+
+void decode_block_sse2(const uint8_t *data, const uint64_t *offsets, const ColumnPointers &columns) {
+  BlockDecoder<Sse2>::decode(data, offsets, columns);
+}
+
+}  // namespace misol_decode
@@ -0,0 +1,49 @@
+// Frames per second of the batch decoder kernels on a clean capture with a frame every 21 bytes
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "batch_decoder.h"
+
+using namespace misol_decode;
+
+int main(int argc, char **argv) {
+  size_t frame_count = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 1000000;
+  const int repetitions = 10;
+  std::mt19937 random(1);
+  std::vector<uint8_t> data;
+  std::vector<uint64_t> offsets;
+  for (size_t i = 0; i < frame_count; i++) {
+    offsets.push_back(data.size());
+    uint8_t frame[21] = {0x24};
+    for (int j = 1; j < 16; j++)
+      frame[j] = random();
+    for (int j = 0; j < 16; j++)
+      frame[16] += frame[j];
+    for (int j = 17; j < 20; j++) {
+      frame[j] = random();
+      frame[20] += frame[j];
+    }
+    data.insert(data.end(), frame, frame + sizeof(frame));
+  }
+
+  FrameColumns columns;
+  double scalar_rate = 0;
+  for (BatchKernel kernel : {BatchKernel::SCALAR, BatchKernel::SSE2, BatchKernel::AVX2, BatchKernel::NEON}) {
+    if (!is_batch_kernel_supported(kernel))
+      continue;
+    decode_batch(data.data(), data.size(), offsets.data(), offsets.size(), columns, kernel);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+      decode_batch(data.data(), data.size(), offsets.data(), offsets.size(), columns, kernel);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double rate = frame_count * repetitions / elapsed.count();
+    if (kernel == BatchKernel::SCALAR)
+      scalar_rate = rate;
+    printf("%-7s %8.1f M frames/s  %5.2fx\n", batch_kernel_to_string(kernel), rate / 1e6, rate / scalar_rate);
+  }
+  return 0;
+}
@@ -0,0 +1,46 @@
+#include "capture_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace misol_decode {
+
+CaptureFile::~CaptureFile() {
+  if (this->data_ != nullptr)
+    munmap(const_cast<uint8_t *>(this->data_), this->size_);
+}
+
+bool CaptureFile::open(const std::string &path, std::string &error) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = strerror(errno);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    error = strerror(errno);
+    close(fd);
+    return false;
+  }
+  this->size_ = st.st_size;
+  if (this->size_ == 0) {
+    close(fd);
+    return true;
+  }
+  void *data = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    error = strerror(errno);
+    this->size_ = 0;
+    return false;
+  }
+  // Captures are scanned once from start to end
+  madvise(data, this->size_, MADV_SEQUENTIAL);
+  this->data_ = static_cast<const uint8_t *>(data);
+  return true;
+}
+
+}  // namespace misol_decode
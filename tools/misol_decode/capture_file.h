@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace misol_decode {
+
+// Read only memory mapping of a raw capture, the bytes exactly as received from the station
+class CaptureFile {
+ public:
+  CaptureFile() = default;
+  CaptureFile(const CaptureFile &) = delete;
+  CaptureFile &operator=(const CaptureFile &) = delete;
+  ~CaptureFile();
+
+  // Returns false and sets error when the file cannot be mapped
+  bool open(const std::string &path, std::string &error);
+  const uint8_t *data() const { return this->data_; }
+  size_t size() const { return this->size_; }
+
+ protected:
+  const uint8_t *data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace misol_decode
@@ -0,0 +1,236 @@
+#include "frame_generator.h"
+#include <algorithm>
+#include <cmath>
+#include "frame_scanner.h"
+
+using namespace esphome::misol_weather;
+
+namespace misol_decode {
+
+namespace {
+
+const float PI = 3.14159265f;
+const float HOURS_PER_DAY = 24.0f;
+const float MM_PER_TIP = 0.3f;
+// Time constants of the slowly varying deviations and their long term standard deviations
+const float TEMPERATURE_DRIFT_DAYS = 2.0f;
+const float TEMPERATURE_DRIFT_SIGMA = 2.0f;
+const float PRESSURE_DRIFT_DAYS = 3.0f;
+const float PRESSURE_DRIFT_SIGMA = 8.0f;
+const float WIND_DRIFT_HOURS = 3.0f;
+// Mean durations of the events
+const float RAIN_HOURS = 1.5f;
+const float GUST_BURST_HOURS = 0.2f;
+const float LOW_BATTERY_HOURS = 6.0f;
+
+template<typename T> T clamp_round(float value, T maximum) {
+  return (T) std::min<float>(std::max<float>(std::lround(value), 0.0f), maximum);
+}
+
+}  // namespace
+
+size_t encode_frame(const DecodedFrame &frame, uint8_t *buffer) {
+  buffer[0] = PACKET_HEADER;
+  buffer[1] = frame.security_code;
+  buffer[2] = frame.wind_direction;
+  buffer[3] = ((frame.wind_direction >> 8) << 7) | ((frame.wind_speed >> 8) << 4) | (frame.low_battery ? 0x08 : 0) |
+              ((frame.temperature >> 8) & 0x07);
+  buffer[4] = frame.temperature;
+  buffer[5] = frame.humidity;
+  buffer[6] = frame.wind_speed;
+  buffer[7] = frame.wind_gust;
+  buffer[8] = frame.precipitation >> 8;
+  buffer[9] = frame.precipitation;
+  buffer[10] = frame.uv_intensity >> 8;
+  buffer[11] = frame.uv_intensity;
+  buffer[12] = frame.light >> 16;
+  buffer[13] = frame.light >> 8;
+  buffer[14] = frame.light;
+  // Not decoded by the component
+  buffer[15] = 0;
+  buffer[16] = 0;
+  for (size_t i = 0; i < 16; i++)
+    buffer[16] += buffer[i];
+  if (!frame.has_pressure)
+    return BASIC_PACKET_SIZE;
+  buffer[17] = frame.pressure >> 16;
+  buffer[18] = frame.pressure >> 8;
+  buffer[19] = frame.pressure;
+  buffer[20] = buffer[17] + buffer[18] + buffer[19];
+  return PRESSURE_PACKET_SIZE;
+}
+
+FrameGenerator::FrameGenerator(const WeatherConfig &weather, const NoiseConfig &noise)
+    : weather_(weather), noise_(noise), random_(weather.seed), precipitation_(weather.precipitation) {
+  this->security_code_ = this->random_();
+  this->hour_ = this->weather_.start_hour;
+  this->wind_speed_ = this->weather_.mean_wind_speed;
+  this->wind_direction_ = this->uniform_(this->random_) * 360.0f;
+  this->next_rain_ = this->wait_days_(this->weather_.rain_events_per_day);
+  this->next_gust_ = this->wait_days_(this->weather_.gust_bursts_per_day);
+  this->next_low_battery_ = this->wait_days_(this->weather_.low_battery_periods_per_day);
+}
+
+double FrameGenerator::wait_days_(float per_day) {
+  if (per_day <= 0.0f)
+    return INFINITY;
+  return std::exponential_distribution<double>(per_day)(this->random_);
+}
+
+void FrameGenerator::next(Transmission &transmission) {
+  uint64_t time_ms = this->transmissions_ * this->weather_.period_ms;
+  if (this->transmissions_ > 0) {
+    float hours = this->weather_.period_ms / 3600000.0f;
+    this->days_ = time_ms / 86400000.0;
+    this->hour_ = std::fmod(this->weather_.start_hour + this->days_ * HOURS_PER_DAY, HOURS_PER_DAY);
+    this->update_events_();
+    this->update_weather_(hours);
+  }
+  this->transmissions_++;
+
+  DecodedFrame frame;
+  this->build_frame_(frame);
+  uint8_t buffer[PRESSURE_PACKET_SIZE];
+  size_t length = encode_frame(frame, buffer);
+  // Decoded again, so quality flags are set exactly as by the component
+  decode_frame(buffer, length, frame.has_pressure, transmission.frame);
+  transmission.time_ms = time_ms;
+  transmission.bytes.assign(buffer, buffer + length);
+  this->apply_noise_(transmission);
+}
+
+void FrameGenerator::update_events_() {
+  if (this->days_ >= this->next_rain_) {
+    this->rain_end_ = this->days_ + std::exponential_distribution<double>(1.0 / RAIN_HOURS)(this->random_) / 24.0;
+    this->next_rain_ = this->rain_end_ + this->wait_days_(this->weather_.rain_events_per_day);
+    // Mostly light rain with the occasional downpour
+    this->rain_rate_ = std::min(0.3f + std::exponential_distribution<float>(1.0f / 3.0f)(this->random_), 60.0f);
+  }
+  if (this->days_ >= this->next_gust_) {
+    this->gust_end_ =
+        this->days_ + std::exponential_distribution<double>(1.0 / GUST_BURST_HOURS)(this->random_) / 24.0;
+    this->next_gust_ = this->gust_end_ + this->wait_days_(this->weather_.gust_bursts_per_day);
+    this->gust_speed_ = 15.0f + this->uniform_(this->random_) * 12.0f;
+  }
+  if (this->days_ >= this->next_low_battery_) {
+    this->low_battery_end_ =
+        this->days_ + std::exponential_distribution<double>(1.0 / LOW_BATTERY_HOURS)(this->random_) / 24.0;
+    this->next_low_battery_ = this->low_battery_end_ + this->wait_days_(this->weather_.low_battery_periods_per_day);
+  }
+}
+
+// Ornstein-Uhlenbeck steps, mean reverting random walks with the given long term standard deviation
+void FrameGenerator::update_weather_(float hours) {
+  float days = hours / HOURS_PER_DAY;
+  this->temperature_drift_ += -this->temperature_drift_ * days / TEMPERATURE_DRIFT_DAYS +
+                              TEMPERATURE_DRIFT_SIGMA * std::sqrt(2.0f * days / TEMPERATURE_DRIFT_DAYS) *
+                                  this->normal_(this->random_);
+  float pressure_target = 1013.0f - ((this->days_ < this->rain_end_) ? 6.0f : 0.0f);
+  this->pressure_ += (pressure_target - this->pressure_) * days / PRESSURE_DRIFT_DAYS +
+                     PRESSURE_DRIFT_SIGMA * std::sqrt(2.0f * days / PRESSURE_DRIFT_DAYS) * this->normal_(this->random_);
+  float wind_sigma = this->weather_.mean_wind_speed * 0.5f;
+  this->wind_speed_ += (this->weather_.mean_wind_speed - this->wind_speed_) * hours / WIND_DRIFT_HOURS +
+                       wind_sigma * std::sqrt(2.0f * hours / WIND_DRIFT_HOURS) * this->normal_(this->random_);
+  this->wind_speed_ = std::max(this->wind_speed_, 0.0f);
+  float turn = 20.0f * std::sqrt(hours) * this->normal_(this->random_);
+  this->wind_direction_ = std::fmod(this->wind_direction_ + turn + 360.0f, 360.0f);
+  if (this->days_ < this->rain_end_) {
+    this->rain_mm_ += this->rain_rate_ * (0.5f + this->uniform_(this->random_)) * hours;
+    while (this->rain_mm_ >= MM_PER_TIP) {
+      // Wraps at the 16 bit limit like the station counter
+      this->precipitation_++;
+      this->rain_mm_ -= MM_PER_TIP;
+    }
+  }
+}
+
+void FrameGenerator::build_frame_(DecodedFrame &frame) {
+  bool raining = this->days_ < this->rain_end_;
+  // Warmest mid afternoon, cooler and humid in the rain
+  float temperature = this->weather_.mean_temperature +
+                      this->weather_.temperature_amplitude * std::cos(2.0f * PI * (this->hour_ - 15.0f) / 24.0f) +
+                      this->temperature_drift_ - (raining ? 2.5f : 0.0f);
+  float humidity = 65.0f - 2.5f * (temperature - this->weather_.mean_temperature) + (raining ? 30.0f : 0.0f);
+  // Sun between 6:00 and 18:00, clouds block most of it in the rain
+  float elevation = std::max(std::sin(PI * (this->hour_ - 6.0f) / 12.0f), 0.0f);
+  float clouds = raining ? 0.15f : 1.0f;
+  float light = 110000.0f * std::pow(elevation, 1.3f) * clouds;
+  float uv_intensity = 3200.0f * elevation * elevation * clouds;
+  // Wind picks up in the afternoon
+  float wind_speed = this->wind_speed_ * (1.0f + 0.4f * elevation);
+  float wind_gust = wind_speed * (1.3f + 0.3f * this->uniform_(this->random_));
+  if (this->days_ < this->gust_end_)
+    wind_gust = std::max(wind_gust, this->gust_speed_ + 2.0f * this->normal_(this->random_));
+
+  frame.security_code = this->security_code_;
+  frame.low_battery = this->days_ < this->low_battery_end_;
+  frame.wind_direction = clamp_round<uint16_t>(this->wind_direction_, 359);
+  frame.temperature = clamp_round<uint16_t>(temperature * 10.0f + 400.0f, 1000);
+  frame.humidity = clamp_round<uint8_t>(humidity, 99);
+  frame.wind_speed = clamp_round<uint16_t>(wind_speed / 0.14f, 357);
+  frame.wind_gust = clamp_round<uint8_t>(wind_gust / 1.12f, 254);
+  frame.precipitation = this->precipitation_;
+  frame.uv_intensity = clamp_round<uint16_t>(uv_intensity, 20000);
+  frame.light = clamp_round<uint32_t>(light * 10.0f, 2000000);
+  frame.has_pressure = this->weather_.pressure;
+  frame.pressure = clamp_round<uint32_t>(this->pressure_ * 100.0f, 110000);
+
+  if (this->chance_(this->weather_.sentinel_probability)) {
+    switch (this->random_() % 7) {
+      case 0:
+        frame.wind_direction = WIND_DIRECTION_NOT_AVAILABLE;
+        break;
+      case 1:
+        frame.temperature = TEMPERATURE_NOT_AVAILABLE;
+        break;
+      case 2:
+        frame.humidity = HUMIDITY_NOT_AVAILABLE;
+        break;
+      case 3:
+        frame.wind_speed = WIND_SPEED_NOT_AVAILABLE;
+        break;
+      case 4:
+        frame.wind_gust = WIND_GUST_NOT_AVAILABLE;
+        break;
+      case 5:
+        frame.uv_intensity = UV_INTENSITY_NOT_AVAILABLE;
+        break;
+      default:
+        frame.light = LIGHT_NOT_AVAILABLE;
+        break;
+    }
+  }
+}
+
+void FrameGenerator::apply_noise_(Transmission &transmission) {
+  std::vector<uint8_t> &bytes = transmission.bytes;
+  transmission.noise = 0;
+  transmission.split = 0;
+  if (this->chance_(this->noise_.bit_flip)) {
+    bytes[this->random_() % bytes.size()] ^= 1 << (this->random_() % 8);
+    transmission.noise |= NOISE_BIT_FLIP;
+  }
+  if (this->chance_(this->noise_.dropped_byte)) {
+    bytes.erase(bytes.begin() + this->random_() % bytes.size());
+    transmission.noise |= NOISE_DROPPED_BYTE;
+  }
+  size_t garbage = 0;
+  if (this->chance_(this->noise_.garbage)) {
+    garbage = 1 + this->random_() % 30;
+    for (size_t i = 0; i < garbage; i++)
+      bytes.insert(bytes.begin(), (this->random_() % 4 == 0) ? PACKET_HEADER : (uint8_t) this->random_());
+    transmission.noise |= NOISE_GARBAGE;
+  }
+  if (this->chance_(this->noise_.split)) {
+    transmission.split = garbage + 1 + this->random_() % (bytes.size() - garbage - 1);
+    transmission.noise |= NOISE_SPLIT;
+  }
+  if ((this->transmissions_ > 1) && this->chance_(this->noise_.concatenated)) {
+    transmission.time_ms = this->previous_end_ms_;
+    transmission.noise |= NOISE_CONCATENATED;
+  }
+  this->previous_end_ms_ = transmission.time_ms + (bytes.size() * BYTE_TIME_US + 999) / 1000 +
+                           ((transmission.split != 0) ? SPLIT_PAUSE_MS : 0);
+}
+
+}  // namespace misol_decode
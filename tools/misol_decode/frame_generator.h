@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "decoded_frame.h"
+
+namespace misol_decode {
+
+struct WeatherConfig {
+  uint32_t seed{1};
+  uint32_t period_ms{16000};
+  bool pressure{true};
+  // Local time of the first frame, the diurnal cycles follow it
+  float start_hour{0.0f};
+  float mean_temperature{12.0f};
+  float temperature_amplitude{6.0f};
+  float mean_wind_speed{3.0f};
+  // Rain events and gust bursts start at random with the given mean rate
+  float rain_events_per_day{1.5f};
+  float gust_bursts_per_day{2.0f};
+  float low_battery_periods_per_day{0.2f};
+  // Probability of a field reported as not available in a frame
+  float sentinel_probability{0.002f};
+  // Rain gauge ticks at the first frame, close to the 16 bit limit so long runs wrap the counter
+  uint16_t precipitation{65536 - 100};
+};
+
+// Link damage, probabilities per transmission
+struct NoiseConfig {
+  float bit_flip{0.0f};
+  float dropped_byte{0.0f};
+  // Random bytes with frame headers before the frame
+  float garbage{0.0f};
+  // The frame arrives in two writes with a pause between them
+  float split{0.0f};
+  // The frame follows the previous one without a pause
+  float concatenated{0.0f};
+};
+
+enum NoiseFlag : uint8_t {
+  NOISE_BIT_FLIP = 1 << 0,
+  NOISE_DROPPED_BYTE = 1 << 1,
+  NOISE_GARBAGE = 1 << 2,
+  NOISE_SPLIT = 1 << 3,
+  NOISE_CONCATENATED = 1 << 4,
+};
+// Noise that changes the bytes of the frame itself
+static const uint8_t NOISE_DAMAGED = NOISE_BIT_FLIP | NOISE_DROPPED_BYTE;
+
+// One transmission of the station as received on the UART
+struct Transmission {
+  uint64_t time_ms;  // of the first byte, since the first transmission
+  esphome::misol_weather::DecodedFrame frame;  // as sent by the station, before noise
+  uint8_t noise;                               // NoiseFlag bits
+  std::vector<uint8_t> bytes;                  // garbage and the frame, with noise
+  size_t split;                                // bytes sent before the pause, 0 when not split
+};
+
+// Time a byte takes on the 9600 bps 8N1 link, rounded up
+static const uint32_t BYTE_TIME_US = 1042;
+static const uint32_t SPLIT_PAUSE_MS = 40;
+
+// Writes the frame in the station wire format with the checksums, returns the length (17, or 21 with pressure)
+size_t encode_frame(const esphome::misol_weather::DecodedFrame &frame, uint8_t *buffer);
+
+// Physically plausible weather of a WH24P station: temperature, humidity, light and UV following the time of day,
+// rain events with the tip counter running through its 16 bit limit, wind with gust bursts, slowly drifting pressure,
+// fields reported as not available and periods of low battery. The same seed gives the same transmissions.
+class FrameGenerator {
+ public:
+  FrameGenerator(const WeatherConfig &weather, const NoiseConfig &noise);
+
+  void next(Transmission &transmission);
+
+ protected:
+  bool chance_(float probability) { return this->uniform_(this->random_) < probability; }
+  // Time in days until the next event of a Poisson process
+  double wait_days_(float per_day);
+  void update_events_();
+  void update_weather_(float hours);
+  void build_frame_(esphome::misol_weather::DecodedFrame &frame);
+  void apply_noise_(Transmission &transmission);
+
+  WeatherConfig weather_;
+  NoiseConfig noise_;
+  std::mt19937 random_;
+  std::uniform_real_distribution<float> uniform_{0.0f, 1.0f};
+  std::normal_distribution<float> normal_{0.0f, 1.0f};
+  uint8_t security_code_;
+  uint64_t transmissions_{0};
+  uint64_t previous_end_ms_{0};
+  double days_{0.0};
+  float hour_{0.0f};
+  // Slowly varying deviations from the diurnal cycles
+  float temperature_drift_{0.0f};
+  float pressure_{1013.0f};
+  float wind_speed_;
+  float wind_direction_;
+  // Rain, gust and battery events: active until the end day, the next one starts at the next day
+  double rain_end_{0.0};
+  double next_rain_;
+  float rain_rate_{0.0f};  // mm/h
+  float rain_mm_{0.0f};    // since the last tip
+  uint16_t precipitation_;
+  double gust_end_{0.0};
+  double next_gust_;
+  float gust_speed_{0.0f};
+  double low_battery_end_{0.0};
+  double next_low_battery_;
+};
+
+}  // namespace misol_decode
@@ -0,0 +1,139 @@
+#include "frame_writer.h"
+#include <cstring>
+
+namespace misol_decode {
+
+using namespace esphome::misol_weather;
+
+const char *const CSV_HEADER =
+    "file,offset,result,wind_direction,low_battery,temperature,humidity,wind_speed,wind_gust,"
+    "accumulated_precipitation,uv_intensity,uv_index,light,pressure,quality,time_ms,precipitation_intensity,raining,"
+    "gust_high\n";
+
+namespace {
+
+// Longest line with every value present
+const size_t MAX_LINE_SIZE = 320;
+
+class CsvLine {
+ public:
+  explicit CsvLine(char *buffer) : buffer_(buffer) {}
+
+  // Comma and value / 10^decimals, only the comma when the value is not available
+  void fixed(bool available, int64_t value, int decimals) {
+    this->put(',');
+    if (!available)
+      return;
+    if (value < 0) {
+      this->put('-');
+      value = -value;
+    }
+    if (decimals == 0) {
+      this->put((uint64_t) value);
+      return;
+    }
+    uint64_t scale = (decimals == 1) ? 10 : 100;
+    this->put(value / scale);
+    this->put('.');
+    uint64_t fraction = value % scale;
+    if (decimals == 2)
+      this->put((char) ('0' + fraction / 10));
+    this->put((char) ('0' + fraction % 10));
+  }
+  void put(uint64_t value) {
+    char digits[20];
+    int count = 0;
+    do {
+      digits[count++] = '0' + value % 10;
+      value /= 10;
+    } while (value != 0);
+    while (count > 0)
+      this->put(digits[--count]);
+  }
+  void put(const char *text) {
+    size_t length = strlen(text);
+    memcpy(this->buffer_ + this->length_, text, length);
+    this->length_ += length;
+  }
+  void put(char c) { this->buffer_[this->length_++] = c; }
+  size_t length() const { return this->length_; }
+
+ protected:
+  char *buffer_;
+  size_t length_{0};
+};
+
+}  // namespace
+
+void append_csv_row(const FrameRow &row, std::vector<char> &output) {
+  size_t start = output.size();
+  output.resize(start + MAX_LINE_SIZE);
+  CsvLine line(output.data() + start);
+  const DecodedFrame &frame = row.frame;
+  line.put((uint64_t) row.file);
+  line.put(',');
+  line.put(row.offset);
+  line.put(',');
+  line.put(frame_result_to_string(row.result));
+  if (row.has_values()) {
+    // Wire units are exact decimal fractions of the physical units, so the values are written with integer
+    // arithmetic: the same digits as the device, without the cost of floating point formatting
+    line.fixed(frame.wind_direction != WIND_DIRECTION_NOT_AVAILABLE, frame.wind_direction, 0);
+    line.fixed(true, frame.low_battery, 0);
+    line.fixed(frame.temperature != TEMPERATURE_NOT_AVAILABLE, frame.temperature - 400, 1);
+    line.fixed(frame.humidity != HUMIDITY_NOT_AVAILABLE, frame.humidity, 0);
+    line.fixed(frame.wind_speed != WIND_SPEED_NOT_AVAILABLE, frame.wind_speed * 14, 2);
+    line.fixed(frame.wind_gust != WIND_GUST_NOT_AVAILABLE, frame.wind_gust * 112, 2);
+    line.fixed(true, frame.precipitation * 3, 1);
+    line.fixed(frame.uv_intensity != UV_INTENSITY_NOT_AVAILABLE, frame.uv_intensity, 1);
+    line.fixed(frame.uv_intensity != UV_INTENSITY_NOT_AVAILABLE, frame.uv_intensity / 400, 0);
+    line.fixed(frame.light != LIGHT_NOT_AVAILABLE, frame.light, 1);
+    line.fixed(frame.has_pressure, frame.pressure, 2);
+    line.put(',');
+    line.put(frame.quality);
+  } else {
+    line.put(",,,,,,,,,,,,");
+  }
+  line.fixed(true, row.time_ms, 0);
+  line.fixed(row.precipitation_intensity != INTENSITY_NOT_AVAILABLE, row.precipitation_intensity, 1);
+  line.fixed(row.raining != FLAG_NOT_AVAILABLE, row.raining, 0);
+  line.fixed(row.gust_high != FLAG_NOT_AVAILABLE, row.gust_high, 0);
+  line.put('\n');
+  output.resize(start + line.length());
+}
+
+ColumnWriter::ColumnWriter(FILE *output) : sink_(output), encoder_(&this->sink_, ROWS_PER_GROUP) {
+  this->file_ = this->encoder_.add_column("file", ColumnType::UINT16, false);
+  this->offset_ = this->encoder_.add_column("offset", ColumnType::UINT64, false);
+  this->schema_.add_to(this->encoder_);
+  this->time_ms_ = this->encoder_.add_column("time_ms", ColumnType::UINT64, false);
+  this->precipitation_intensity_ = this->encoder_.add_column("precipitation_intensity", ColumnType::INT32, true, 0.1);
+  this->raining_ = this->encoder_.add_column("raining", ColumnType::UINT8, true);
+  this->gust_high_ = this->encoder_.add_column("gust_high", ColumnType::UINT8, true);
+}
+
+void ColumnWriter::write(const FrameRow &row) {
+  this->encoder_.set(this->file_, row.file);
+  this->encoder_.set(this->offset_, row.offset);
+  this->schema_.set(this->encoder_, row.result, row.has_values() ? &row.frame : nullptr);
+  this->encoder_.set(this->time_ms_, row.time_ms);
+  if (row.precipitation_intensity != INTENSITY_NOT_AVAILABLE)
+    this->encoder_.set(this->precipitation_intensity_, row.precipitation_intensity);
+  if (row.raining != FLAG_NOT_AVAILABLE)
+    this->encoder_.set(this->raining_, row.raining);
+  if (row.gust_high != FLAG_NOT_AVAILABLE)
+    this->encoder_.set(this->gust_high_, row.gust_high);
+  this->encoder_.end_row();
+}
+
+bool ColumnWriter::finish() {
+  this->encoder_.finish();
+  return !this->sink_.failed;
+}
+
+void ColumnWriter::FileSink::write(const uint8_t *data, size_t length) {
+  if (fwrite(data, 1, length, this->output_) != length)
+    this->failed = true;
+}
+
+}  // namespace misol_decode
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "column_encoder.h"
+#include "decoded_frame.h"
+#include "flight_recorder.h"
+
+namespace misol_decode {
+
+using esphome::misol_weather::DecodedFrame;
+using esphome::misol_weather::FrameResult;
+
+static const uint8_t FLAG_NOT_AVAILABLE = 0xFF;
+static const int32_t INTENSITY_NOT_AVAILABLE = -1;
+
+struct FrameRow {
+  uint16_t file;    // index of the capture in the command line
+  uint8_t length;   // of frames with values, 17 or 21 bytes
+  FrameResult result;
+  uint64_t offset;  // of the first frame byte in the capture
+  DecodedFrame frame;  // default (all values not available) for frames that failed the checks
+
+  // Derived from this and the preceding frames of the station, see StationMetrics
+  uint64_t time_ms{0};  // since the first frame of the station
+  int32_t precipitation_intensity{INTENSITY_NOT_AVAILABLE};  // 0.1 mm/h
+  uint8_t raining{FLAG_NOT_AVAILABLE};
+  uint8_t gust_high{FLAG_NOT_AVAILABLE};
+
+  bool has_values() const {
+    return (this->result == FrameResult::BASIC_PACKET) || (this->result == FrameResult::BASIC_WITH_PRESSURE) ||
+           (this->result == FrameResult::PRESSURE_CHECKSUM_FAILURE);
+  }
+};
+
+// Header line of the CSV output
+extern const char *const CSV_HEADER;
+
+// Appends the CSV line of the row in physical units, empty for values that are not available. Rows are formatted
+// independently, so lines of different rows can be built concurrently and concatenated.
+void append_csv_row(const FrameRow &row, std::vector<char> &output);
+
+// Column file (see ColumnEncoder) with the frame columns, the capture index, the offset and the derived values.
+// Row groups of 65535 rows, only one is kept in memory.
+class ColumnWriter {
+ public:
+  static const uint16_t ROWS_PER_GROUP = 65535;
+
+  explicit ColumnWriter(FILE *output);
+  void write(const FrameRow &row);
+  // Returns false when the output could not be written
+  bool finish();
+
+ protected:
+  class FileSink : public esphome::misol_weather::ColumnSink {
+   public:
+    explicit FileSink(FILE *output) : output_(output) {}
+    void write(const uint8_t *data, size_t length) override;
+    bool failed{false};
+
+   protected:
+    FILE *output_;
+  };
+
+  FileSink sink_;
+  esphome::misol_weather::ColumnEncoder encoder_;
+  esphome::misol_weather::FrameColumnSchema schema_;
+  uint8_t file_;
+  uint8_t offset_;
+  uint8_t time_ms_;
+  uint8_t precipitation_intensity_;
+  uint8_t raining_;
+  uint8_t gust_high_;
+};
+
+}  // namespace misol_decode
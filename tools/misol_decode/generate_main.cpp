@@ -0,0 +1,218 @@
+// Writes synthetic station output for load and soak tests of the component and the host tools: plausible weather
+// in checksummed frames with optional link damage, to a file or a pseudo-terminal, paced like the real station or
+// faster.
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "frame_generator.h"
+
+using namespace misol_decode;
+
+namespace {
+
+// Unpaced output is written in large pieces
+const size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
+void usage() {
+  fprintf(stderr,
+          "Usage: misol_generate [options]\n"
+          "  -o output            output file, standard output by default\n"
+          "  --pty                create a pseudo-terminal and write to it, its path is printed\n"
+          "  -n frames            number of transmissions, default 5400 (one day)\n"
+          "  --days days          number of transmissions for the given time instead\n"
+          "  --speed factor       pace relative to real time, 0 for as fast as possible,\n"
+          "                       default 1 with --pty and 0 otherwise\n"
+          "  --seed number        random seed, default 1\n"
+          "  --period seconds     transmission period, default 16\n"
+          "  --no-pressure        17 byte frames without the pressure trailer\n"
+          "  --start-hour hour    local time of the first frame, default 0\n"
+          "  --rain-counter ticks rain gauge counter at the start, default 65436\n"
+          "  --noise probability  every kind of link damage with the given probability per frame\n"
+          "  --bit-flips, --dropped-bytes, --garbage, --split, --concatenated probability\n"
+          "                       one kind of link damage\n");
+}
+
+class Output {
+ public:
+  Output(int fd, double speed) : fd_(fd), speed_(speed), start_(std::chrono::steady_clock::now()) {}
+
+  // Writes the bytes once the simulated time is reached
+  bool write(const uint8_t *data, size_t length, uint64_t time_ms) {
+    if (this->speed_ <= 0.0) {
+      this->buffer_.insert(this->buffer_.end(), data, data + length);
+      return (this->buffer_.size() < OUTPUT_BUFFER_SIZE) || this->flush();
+    }
+    auto elapsed = std::chrono::microseconds((int64_t) (time_ms * 1000 / this->speed_));
+    std::this_thread::sleep_until(this->start_ + elapsed);
+    return this->write_all_(data, length);
+  }
+  bool flush() {
+    bool written = this->write_all_(this->buffer_.data(), this->buffer_.size());
+    this->buffer_.clear();
+    return written;
+  }
+
+ protected:
+  bool write_all_(const uint8_t *data, size_t length) {
+    while (length > 0) {
+      ssize_t written = ::write(this->fd_, data, length);
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      data += written;
+      length -= written;
+    }
+    return true;
+  }
+
+  int fd_;
+  double speed_;
+  std::chrono::steady_clock::time_point start_;
+  std::vector<uint8_t> buffer_;
+};
+
+// The slave side is kept open as well, so readers can close and reopen it without a hangup
+int open_pty(int &slave) {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0))
+    return -1;
+  const char *name = ptsname(master);
+  slave = (name != nullptr) ? open(name, O_RDWR | O_NOCTTY) : -1;
+  struct termios attributes;
+  if ((slave < 0) || (tcgetattr(slave, &attributes) != 0))
+    return -1;
+  cfmakeraw(&attributes);
+  cfsetspeed(&attributes, B9600);
+  if (tcsetattr(slave, TCSANOW, &attributes) != 0)
+    return -1;
+  fprintf(stderr, "misol_generate: writing to %s\n", name);
+  return master;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *output_path = nullptr;
+  bool pty = false;
+  uint64_t frames = 5400;
+  double days = 0.0;
+  double speed = -1.0;
+  WeatherConfig weather;
+  NoiseConfig noise;
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if ((strcmp(argv[i], "-o") == 0) && has_value) {
+      output_path = argv[++i];
+    } else if (strcmp(argv[i], "--pty") == 0) {
+      pty = true;
+    } else if ((strcmp(argv[i], "-n") == 0) && has_value) {
+      frames = strtoull(argv[++i], nullptr, 10);
+    } else if ((strcmp(argv[i], "--days") == 0) && has_value) {
+      days = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--speed") == 0) && has_value) {
+      speed = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--seed") == 0) && has_value) {
+      weather.seed = strtoul(argv[++i], nullptr, 10);
+    } else if ((strcmp(argv[i], "--period") == 0) && has_value) {
+      weather.period_ms = strtod(argv[++i], nullptr) * 1000;
+    } else if (strcmp(argv[i], "--no-pressure") == 0) {
+      weather.pressure = false;
+    } else if ((strcmp(argv[i], "--start-hour") == 0) && has_value) {
+      weather.start_hour = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--rain-counter") == 0) && has_value) {
+      weather.precipitation = strtoul(argv[++i], nullptr, 10);
+    } else if ((strcmp(argv[i], "--noise") == 0) && has_value) {
+      float probability = strtod(argv[++i], nullptr);
+      noise = NoiseConfig{probability, probability, probability, probability, probability};
+    } else if ((strcmp(argv[i], "--bit-flips") == 0) && has_value) {
+      noise.bit_flip = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--dropped-bytes") == 0) && has_value) {
+      noise.dropped_byte = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--garbage") == 0) && has_value) {
+      noise.garbage = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--split") == 0) && has_value) {
+      noise.split = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "--concatenated") == 0) && has_value) {
+      noise.concatenated = strtod(argv[++i], nullptr);
+    } else if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      usage();
+      return 0;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if ((weather.period_ms == 0) || (pty && (output_path != nullptr))) {
+    usage();
+    return 2;
+  }
+  if (days > 0.0)
+    frames = std::ceil(days * 86400000.0 / weather.period_ms);
+  if (speed < 0.0)
+    speed = pty ? 1.0 : 0.0;
+
+  int fd = STDOUT_FILENO;
+  int slave = -1;
+  if (pty) {
+    fd = open_pty(slave);
+    if (fd < 0) {
+      fprintf(stderr, "misol_generate: creating the pseudo-terminal failed: %s\n", strerror(errno));
+      return 1;
+    }
+  } else if (output_path != nullptr) {
+    fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      fprintf(stderr, "misol_generate: %s: %s\n", output_path, strerror(errno));
+      return 1;
+    }
+  }
+
+  FrameGenerator generator(weather, noise);
+  Output output(fd, speed);
+  Transmission transmission;
+  bool written = true;
+  uint64_t damaged = 0;
+  for (uint64_t i = 0; (i < frames) && written; i++) {
+    generator.next(transmission);
+    if (transmission.noise & NOISE_DAMAGED)
+      damaged++;
+    const uint8_t *bytes = transmission.bytes.data();
+    size_t split = transmission.split;
+    uint64_t rest_ms = transmission.time_ms;
+    if (split != 0) {
+      written = output.write(bytes, split, transmission.time_ms);
+      bytes += split;
+      rest_ms += (split * BYTE_TIME_US + 999) / 1000 + SPLIT_PAUSE_MS;
+    }
+    written = written && output.write(bytes, transmission.bytes.size() - split, rest_ms);
+  }
+  written = written && output.flush();
+  if (!written) {
+    fprintf(stderr, "misol_generate: writing the output failed: %s\n", strerror(errno));
+    return 1;
+  }
+  if (pty) {
+    // Bytes not read yet are lost when the pseudo-terminal goes away, readers get a moment to take them
+    int pending = 0;
+    for (int i = 0; (i < 200) && (ioctl(slave, FIONREAD, &pending) == 0) && (pending > 0); i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    close(slave);
+  }
+  if ((fd != STDOUT_FILENO) && (close(fd) != 0))
+    return 1;
+  fprintf(stderr, "misol_generate: %llu frames, %llu damaged\n", (unsigned long long) frames,
+          (unsigned long long) damaged);
+  return 0;
+}
@@ -0,0 +1,233 @@
+// Decodes raw captures of the station output (the bytes exactly as received on the UART) with the frame
+// scanning and decoding of the component, so archived data is interpreted exactly as the device would.
+//
+// Captures are split into shards scanned and decoded in parallel, then joined at frame boundaries. Values derived
+// from the frame sequence are computed per station with the state carried from shard to shard, stations in
+// parallel, and the output is formatted in parallel and written in capture order: the output does not depend on
+// the number of threads or the shard size.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "capture_file.h"
+#include "frame_scanner.h"
+#include "frame_writer.h"
+#include "parallel.h"
+#include "shard_scanner.h"
+#include "station_metrics.h"
+
+using namespace esphome::misol_weather;
+using namespace misol_decode;
+
+namespace {
+
+// Large stdio buffer for the column output, which is written in many small pieces
+const size_t OUTPUT_BUFFER_SIZE = 4 << 20;
+const uint64_t DEFAULT_SHARD_SIZE = 4 << 20;
+// Shards in flight per thread, bounds the memory used for decoded rows
+const unsigned SHARDS_PER_THREAD = 2;
+
+void usage() {
+  fprintf(stderr,
+          "Usage: misol_decode [options] capture...\n"
+          "  -f csv|columns      output format, csv (default) or columns (column file)\n"
+          "  -o output           output file, standard output by default\n"
+          "  --all               also write frames that failed the checks, without values\n"
+          "  -j threads          worker threads, the number of cores by default\n"
+          "  --shard-size bytes  capture bytes scanned by a worker at once, default 4194304\n"
+          "  --period seconds    transmission period of the station, default 16\n"
+          "  --filter hampel|median  outlier filter with the device defaults, off by default\n"
+          "Captures in the same directory are one station, given in time order.\n");
+}
+
+struct Shard {
+  uint16_t file;
+  uint64_t start;
+  uint64_t end;
+};
+
+struct Totals {
+  uint64_t frames{0};
+  uint64_t failed{0};
+  uint64_t bytes{0};
+  uint64_t frame_bytes{0};
+  uint64_t rescans{0};
+};
+
+std::string station_of(const std::string &path) {
+  size_t slash = path.rfind('/');
+  return (slash == std::string::npos) ? "." : path.substr(0, slash);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *format = "csv";
+  const char *output_path = nullptr;
+  bool all = false;
+  unsigned threads = std::thread::hardware_concurrency();
+  uint64_t shard_size = DEFAULT_SHARD_SIZE;
+  MetricsConfig config;
+  std::vector<std::string> captures;
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if ((strcmp(argv[i], "-f") == 0) && has_value) {
+      format = argv[++i];
+    } else if ((strcmp(argv[i], "-o") == 0) && has_value) {
+      output_path = argv[++i];
+    } else if (strcmp(argv[i], "--all") == 0) {
+      all = true;
+    } else if ((strcmp(argv[i], "-j") == 0) && has_value) {
+      threads = strtoul(argv[++i], nullptr, 10);
+    } else if ((strcmp(argv[i], "--shard-size") == 0) && has_value) {
+      shard_size = strtoull(argv[++i], nullptr, 10);
+    } else if ((strcmp(argv[i], "--period") == 0) && has_value) {
+      config.period_ms = strtod(argv[++i], nullptr) * 1000;
+    } else if ((strcmp(argv[i], "--filter") == 0) && has_value) {
+      const char *method = argv[++i];
+      config.filter = true;
+      if (strcmp(method, "hampel") == 0) {
+        config.filter_method = OutlierFilterMethod::HAMPEL;
+      } else if (strcmp(method, "median") == 0) {
+        config.filter_method = OutlierFilterMethod::MEDIAN;
+      } else {
+        usage();
+        return 2;
+      }
+    } else if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      usage();
+      return 0;
+    } else if (argv[i][0] == '-') {
+      usage();
+      return 2;
+    } else {
+      captures.push_back(argv[i]);
+    }
+  }
+  bool csv = strcmp(format, "csv") == 0;
+  if (captures.empty() || (captures.size() > UINT16_MAX) || (!csv && (strcmp(format, "columns") != 0)) ||
+      (shard_size == 0) || (config.period_ms == 0)) {
+    usage();
+    return 2;
+  }
+  if (threads == 0)
+    threads = 1;
+
+  int status = 0;
+  Totals totals;
+  std::vector<std::unique_ptr<CaptureFile>> files;
+  std::vector<std::unique_ptr<ShardStitcher>> stitchers;
+  std::vector<size_t> file_stations;
+  std::map<std::string, size_t> station_indices;
+  std::vector<Shard> shards;
+  for (size_t i = 0; i < captures.size(); i++) {
+    files.push_back(std::make_unique<CaptureFile>());
+    CaptureFile &capture = *files.back();
+    std::string error;
+    if (!capture.open(captures[i], error)) {
+      fprintf(stderr, "misol_decode: %s: %s\n", captures[i].c_str(), error.c_str());
+      status = 1;
+    }
+    stitchers.push_back(std::make_unique<ShardStitcher>(capture.data(), capture.size(), i));
+    auto station = station_indices.emplace(station_of(captures[i]), station_indices.size()).first;
+    file_stations.push_back(station->second);
+    for (uint64_t start = 0; start < capture.size(); start += shard_size)
+      shards.push_back(Shard{(uint16_t) i, start, std::min<uint64_t>(start + shard_size, capture.size())});
+    totals.bytes += capture.size();
+  }
+  std::vector<std::unique_ptr<StationMetrics>> stations;
+  for (size_t i = 0; i < station_indices.size(); i++)
+    stations.push_back(std::make_unique<StationMetrics>(config));
+
+  FILE *output = stdout;
+  if (output_path != nullptr) {
+    output = fopen(output_path, "wb");
+    if (output == nullptr) {
+      fprintf(stderr, "misol_decode: %s: %s\n", output_path, strerror(errno));
+      return 1;
+    }
+  }
+  setvbuf(output, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+  std::unique_ptr<ColumnWriter> columns;
+  bool write_failed = false;
+  if (csv) {
+    write_failed = fputs(CSV_HEADER, output) < 0;
+  } else {
+    columns = std::make_unique<ColumnWriter>(output);
+  }
+
+  size_t batch_size = threads * SHARDS_PER_THREAD;
+  std::vector<ShardScan> scans(batch_size);
+  std::vector<std::vector<char>> lines(batch_size);
+  for (size_t batch = 0; batch < shards.size(); batch += batch_size) {
+    size_t count = std::min(batch_size, shards.size() - batch);
+    parallel_for(count, threads, [&](size_t i) {
+      const Shard &shard = shards[batch + i];
+      const CaptureFile &capture = *files[shard.file];
+      scan_shard(capture.data(), capture.size(), shard.file, shard.start, shard.end, scans[i]);
+    });
+    // Joining is cheap unless a shard has to be rescanned
+    std::vector<std::vector<size_t>> station_scans(stations.size());
+    for (size_t i = 0; i < count; i++) {
+      uint16_t file = shards[batch + i].file;
+      stitchers[file]->stitch(scans[i]);
+      station_scans[file_stations[file]].push_back(i);
+      for (const FrameRow &row : scans[i].rows) {
+        if (row.has_values()) {
+          totals.frames++;
+          totals.frame_bytes += row.length;
+        } else {
+          totals.failed++;
+        }
+      }
+    }
+    parallel_for(stations.size(), threads, [&](size_t station) {
+      for (size_t i : station_scans[station]) {
+        for (FrameRow &row : scans[i].rows)
+          stations[station]->update(row);
+      }
+    });
+    if (csv) {
+      parallel_for(count, threads, [&](size_t i) {
+        lines[i].clear();
+        for (const FrameRow &row : scans[i].rows) {
+          if (all || row.has_values())
+            append_csv_row(row, lines[i]);
+        }
+      });
+      for (size_t i = 0; i < count; i++) {
+        if (fwrite(lines[i].data(), 1, lines[i].size(), output) != lines[i].size())
+          write_failed = true;
+      }
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        for (const FrameRow &row : scans[i].rows) {
+          if (all || row.has_values())
+            columns->write(row);
+        }
+      }
+    }
+  }
+  for (const auto &stitcher : stitchers)
+    totals.rescans += stitcher->get_rescans();
+
+  if (columns != nullptr)
+    write_failed |= !columns->finish();
+  write_failed |= fflush(output) != 0;
+  if (write_failed) {
+    fprintf(stderr, "misol_decode: writing the output failed\n");
+    status = 1;
+  }
+  if ((output != stdout) && (fclose(output) != 0))
+    status = 1;
+  fprintf(stderr, "misol_decode: %llu frames, %llu failed, %llu bytes discarded, %llu shards rescanned\n",
+          (unsigned long long) totals.frames, (unsigned long long) totals.failed,
+          (unsigned long long) (totals.bytes - totals.frame_bytes), (unsigned long long) totals.rescans);
+  return status;
+}
@@ -0,0 +1,227 @@
+"""Reader of the column files written by the history endpoint and ``misol_decode -f columns``.
+
+The layout is described in components/misol_weather/column_encoder.h. Only the standard library is needed, numpy
+and pandas are used when they are installed:
+
+    import mwcf
+    table = mwcf.read("history.mwc")
+    table["temperature"].values()  # physical values, None for null
+    table["temperature"].to_numpy()  # float64 with NaN for null
+    table.to_pandas()
+
+Run as a script to print a file as CSV: python3 mwcf.py history.mwc
+"""
+
+import array
+import struct
+import sys
+
+MAGIC = b"MWCF"
+VERSION = 1
+
+UINT8 = 1
+UINT16 = 2
+UINT32 = 3
+UINT64 = 4
+INT32 = 5
+DICTIONARY = 6
+
+# array type codes of the value types, checked against the item size below
+_TYPE_CODES = {UINT8: "B", UINT16: "H", UINT32: "I", UINT64: "Q", INT32: "i", DICTIONARY: "B"}
+_TYPE_SIZES = {UINT8: 1, UINT16: 2, UINT32: 4, UINT64: 8, INT32: 4, DICTIONARY: 1}
+
+
+class FormatError(ValueError):
+    pass
+
+
+class Column:
+    def __init__(self, name, type_, nullable, scale, offset, labels):
+        self.name = name
+        self.type = type_
+        self.nullable = nullable
+        self.scale = scale
+        self.offset = offset
+        self.labels = labels
+        # Raw integers, 0 for null, and whether each row has a value
+        self.raw = array.array(_TYPE_CODES[type_])
+        self.valid = []
+
+    def __len__(self):
+        return len(self.raw)
+
+    @property
+    def is_scaled(self):
+        return (self.scale != 1.0) or (self.offset != 0.0)
+
+    def values(self):
+        """Physical values, labels for dictionary columns, None for null."""
+        if self.type == DICTIONARY:
+            return [self.labels[raw] if valid else None for raw, valid in zip(self.raw, self.valid)]
+        if self.is_scaled:
+            return [raw * self.scale + self.offset if valid else None for raw, valid in zip(self.raw, self.valid)]
+        return [raw if valid else None for raw, valid in zip(self.raw, self.valid)]
+
+    def to_numpy(self):
+        """float64 with NaN for null, the label indices with -1 for null for dictionary columns, the raw integers
+        for columns that cannot be null."""
+        import numpy
+
+        raw = numpy.frombuffer(self.raw.tobytes(), dtype=self.raw.typecode)
+        valid = numpy.array(self.valid, dtype=bool)
+        if self.type == DICTIONARY:
+            return numpy.where(valid, raw.astype(numpy.int16), -1)
+        if not self.nullable and not self.is_scaled:
+            return raw.copy()
+        return numpy.where(valid, raw * self.scale + self.offset, numpy.nan)
+
+
+class Table:
+    def __init__(self, columns, row_groups):
+        self.columns = columns
+        self.row_groups = row_groups
+
+    def __getitem__(self, name):
+        for column in self.columns:
+            if column.name == name:
+                return column
+        raise KeyError(name)
+
+    @property
+    def names(self):
+        return [column.name for column in self.columns]
+
+    @property
+    def rows(self):
+        return len(self.columns[0]) if self.columns else 0
+
+    def to_pandas(self):
+        """DataFrame with categoricals for dictionary columns and nullable integers for unscaled columns."""
+        import pandas
+
+        data = {}
+        for column in self.columns:
+            if column.type == DICTIONARY:
+                data[column.name] = pandas.Categorical.from_codes(column.to_numpy(), categories=column.labels)
+            elif column.is_scaled:
+                data[column.name] = column.to_numpy()
+            else:
+                dtype = "Int32" if column.type == INT32 else "UInt%d" % (8 * _TYPE_SIZES[column.type])
+                data[column.name] = pandas.array(column.values(), dtype=dtype)
+        return pandas.DataFrame(data)
+
+
+class _Reader:
+    def __init__(self, data):
+        self.data = data
+        self.position = 0
+
+    def take(self, length):
+        if self.position + length > len(self.data):
+            raise FormatError("file ends within the data at byte %d" % self.position)
+        chunk = self.data[self.position : self.position + length]
+        self.position += length
+        return chunk
+
+    def unpack(self, format_):
+        return struct.unpack("<" + format_, self.take(struct.calcsize("<" + format_)))[0]
+
+    def string(self):
+        return bytes(self.take(self.unpack("B"))).decode("utf-8")
+
+
+def parse(data):
+    """Reads a column file from bytes."""
+    reader = _Reader(memoryview(data))
+    if bytes(reader.take(4)) != MAGIC:
+        raise FormatError("not a column file")
+    version = reader.unpack("B")
+    if version != VERSION:
+        raise FormatError("version %d is not supported" % version)
+    columns = []
+    for _ in range(reader.unpack("B")):
+        name = reader.string()
+        type_ = reader.unpack("B")
+        if type_ not in _TYPE_CODES:
+            raise FormatError("column %s has the unknown type %d" % (name, type_))
+        nullable = reader.unpack("B") != 0
+        scale = reader.unpack("d")
+        offset = reader.unpack("d")
+        labels = None
+        if type_ == DICTIONARY:
+            labels = [reader.string() for _ in range(reader.unpack("B"))]
+        columns.append(Column(name, type_, nullable, scale, offset, labels))
+    for column in columns:
+        if column.raw.itemsize != _TYPE_SIZES[column.type]:
+            raise FormatError("no %d byte integer type on this platform" % _TYPE_SIZES[column.type])
+
+    row_groups = 0
+    while True:
+        rows = reader.unpack("I")
+        if rows == 0:
+            break
+        row_groups += 1
+        for column in columns:
+            if column.nullable:
+                bitmap = reader.take((rows + 7) // 8)
+                column.valid.extend(bool((bitmap[row // 8] >> (row % 8)) & 1) for row in range(rows))
+            else:
+                column.valid.extend([True] * rows)
+            values = array.array(column.raw.typecode)
+            values.frombytes(reader.take(rows * values.itemsize))
+            if sys.byteorder == "big":
+                values.byteswap()
+            column.raw.extend(values)
+    if reader.position != len(data):
+        raise FormatError("%d bytes after the end marker" % (len(data) - reader.position))
+    return Table(columns, row_groups)
+
+
+def read(path):
+    """Reads a column file, path is a file name or a binary file object."""
+    if hasattr(path, "read"):
+        return parse(path.read())
+    with open(path, "rb") as file:
+        return parse(file.read())
+
+
+def _decimals(scale):
+    for decimals in range(7):
+        if abs(round(scale, decimals) - scale) < 1e-9:
+            return decimals
+    return 6
+
+
+def write_csv(table, output):
+    """Writes the physical values with the resolution of the scale, nulls as empty fields."""
+    output.write(",".join(table.names) + "\n")
+    formats = []
+    for column in table.columns:
+        if column.type == DICTIONARY or not column.is_scaled:
+            formats.append("%s")
+        else:
+            formats.append("%%.%df" % _decimals(column.scale))
+    values = [column.values() for column in table.columns]
+    for row in range(table.rows):
+        fields = []
+        for format_, column in zip(formats, values):
+            value = column[row]
+            fields.append("" if value is None else format_ % value)
+        output.write(",".join(fields) + "\n")
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("Usage: mwcf.py file\n")
+        return 2
+    try:
+        table = read(argv[1])
+    except (OSError, FormatError) as error:
+        sys.stderr.write("mwcf.py: %s: %s\n" % (argv[1], error))
+        return 1
+    write_csv(table, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
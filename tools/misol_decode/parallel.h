@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace misol_decode {
+
+// Calls function(index) for every index below count on up to threads threads. Indices are taken in order,
+// which one runs on which thread is not defined, so the results must not depend on it.
+template<typename Function> void parallel_for(size_t count, unsigned threads, Function &&function) {
+  if ((threads <= 1) || (count <= 1)) {
+    for (size_t i = 0; i < count; i++)
+      function(i);
+    return;
+  }
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < count; i = next++)
+      function(i);
+  };
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; (i < threads) && (i < count); i++)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &thread : workers)
+    thread.join();
+}
+
+}  // namespace misol_decode
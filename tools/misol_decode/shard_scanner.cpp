@@ -0,0 +1,70 @@
+#include "shard_scanner.h"
+#include <algorithm>
+#include "frame_scanner.h"
+
+namespace misol_decode {
+
+using namespace esphome::misol_weather;
+
+// Scanned in pieces to stop soon after the handoff frame, a piece is much longer than a frame
+static const size_t SCAN_PIECE_SIZE = 4096;
+
+void scan_shard(const uint8_t *data, size_t size, uint16_t file, uint64_t start, uint64_t end, ShardScan &scan) {
+  scan.start = start;
+  scan.end = end;
+  scan.rows.clear();
+  scan.handoff = size;
+  bool in_sync = true;
+  bool handoff_found = false;
+  uint64_t position = start;
+  FrameRow row{};
+  row.file = file;
+  while ((position < size) && !handoff_found) {
+    size_t length = std::min<uint64_t>(SCAN_PIECE_SIZE, size - position);
+    bool flush = position + length == size;
+    position += scan_frames(
+        data + position, length, flush, check_packet,
+        [&](size_t offset, size_t frame_length, FrameResult result) {
+          if (handoff_found)
+            return;
+          row.offset = position + offset;
+          row.result = result;
+          row.frame = DecodedFrame();
+          if (row.has_values()) {
+            if (row.offset >= end) {
+              scan.handoff = row.offset;
+              handoff_found = true;
+              return;
+            }
+            row.length = frame_length;
+            decode_frame(data + row.offset, frame_length, result == FrameResult::BASIC_WITH_PRESSURE, row.frame);
+          } else {
+            row.length = 0;
+          }
+          scan.rows.push_back(row);
+        },
+        [](size_t, bool) {}, in_sync);
+  }
+}
+
+void ShardStitcher::stitch(ShardScan &scan) {
+  if (this->next_ >= scan.end) {
+    // A frame of the previous shard or garbage covers the whole shard
+    scan.rows.clear();
+    return;
+  }
+  auto first = scan.rows.begin();
+  if (scan.start != this->next_) {
+    first = std::find_if(scan.rows.begin(), scan.rows.end(),
+                         [this](const FrameRow &row) { return row.has_values() && (row.offset == this->next_); });
+    if (first == scan.rows.end()) {
+      this->rescans_++;
+      scan_shard(this->data_, this->size_, this->file_, this->next_, scan.end, scan);
+      first = scan.rows.begin();
+    }
+  }
+  scan.rows.erase(scan.rows.begin(), first);
+  this->next_ = scan.handoff;
+}
+
+}  // namespace misol_decode
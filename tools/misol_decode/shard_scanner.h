@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frame_writer.h"
+
+namespace misol_decode {
+
+// Frames found by scanning a byte range of a capture on its own
+struct ShardScan {
+  uint64_t start;
+  uint64_t end;
+  // Every frame from start up to the handoff, frames with values decoded
+  std::vector<FrameRow> rows;
+  // Offset of the first frame with values at or after end, the size of the capture when there is none.
+  // Scanning continues past end up to it, so the next shard can take over at a frame boundary.
+  uint64_t handoff;
+};
+
+// Scans [start, end) of the capture as if the capture started at start
+void scan_shard(const uint8_t *data, size_t size, uint16_t file, uint64_t start, uint64_t end, ShardScan &scan);
+
+// Joins shards of one capture scanned independently into exactly the frames of a scan of the whole capture.
+// Shards are passed in order, next is the offset of the first frame with values not taken yet (0 for the first
+// shard). A shard scanned from an offset that is not a frame boundary of the whole capture can start with frames
+// the whole scan does not see; once both scans have a frame with values at the same offset they continue
+// identically, as the scanner state after a frame with values is always the same. A shard without that frame is
+// rescanned from next, which is rare: it takes a run of garbage longer than the shard.
+class ShardStitcher {
+ public:
+  ShardStitcher(const uint8_t *data, size_t size, uint16_t file) : data_(data), size_(size), file_(file) {}
+
+  // Drops the frames of the shard the whole scan does not see
+  void stitch(ShardScan &scan);
+  uint64_t get_rescans() const { return this->rescans_; }
+
+ protected:
+  const uint8_t *data_;
+  size_t size_;
+  uint16_t file_;
+  uint64_t next_{0};
+  uint64_t rescans_{0};
+};
+
+}  // namespace misol_decode
@@ -0,0 +1,44 @@
+#include "station_metrics.h"
+
+namespace misol_decode {
+
+using namespace esphome::misol_weather;
+
+// Device defaults of the outlier filter
+static const uint8_t FILTER_WINDOW_SIZE = 5;
+static const float FILTER_THRESHOLD = 3.0f;
+
+StationMetrics::StationMetrics(const MetricsConfig &config)
+    : config_(config),
+      rain_(config.dry_time_ms),
+      gust_(config.gust_lower, config.gust_upper),
+      intensity_(config.intensity_interval_ms) {
+  if (config.filter) {
+    this->filter_ = std::make_unique<FrameFilter>(config.filter_method, FILTER_WINDOW_SIZE, FILTER_THRESHOLD);
+    for (uint8_t field = 0; field < FIELD_COUNT; field++)
+      this->filter_->enable_field((Field) field);
+  }
+}
+
+void StationMetrics::update(FrameRow &row) {
+  row.time_ms = this->transmissions_++ * this->config_.period_ms;
+  if (!row.has_values())
+    return;
+  DecodedFrame &frame = row.frame;
+  if (this->filter_ != nullptr)
+    frame.add_quality(this->filter_->apply(frame), QUALITY_FILTERED);
+  // Wraps after 49 days like the millisecond clock of the device, the detector only uses differences
+  this->rain_.update(frame.precipitation, (uint32_t) row.time_ms);
+  row.raining = this->rain_.is_raining();
+  float gust = frame.get_wind_gust();
+  this->gust_.update(gust);
+  if (!std::isnan(gust))
+    row.gust_high = this->gust_.is_high();
+  // Like the device without a wall clock, the intensity of a window is set with the first frame of the next one
+  this->intensity_.update(frame.precipitation, (uint32_t) row.time_ms, 0);
+  float intensity = this->intensity_.get_intensity();
+  if (!std::isnan(intensity))
+    row.precipitation_intensity = (int32_t) lroundf(intensity * 10.0f);
+}
+
+}  // namespace misol_decode
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "edge_detector.h"
+#include "frame_filter.h"
+#include "intensity_window.h"
+#include "frame_writer.h"
+
+namespace misol_decode {
+
+struct MetricsConfig {
+  // Raw captures carry no time, the station transmits with a fixed period
+  uint32_t period_ms{16000};
+  uint32_t intensity_interval_ms{5 * 60 * 1000};
+  uint32_t dry_time_ms{30 * 60 * 1000};
+  // Gale (Beaufort 8) from 17.2 m/s, cleared below strong breeze levels
+  float gust_lower{13.9f};
+  float gust_upper{17.2f};
+  bool filter{false};
+  esphome::misol_weather::OutlierFilterMethod filter_method{esphome::misol_weather::OutlierFilterMethod::HAMPEL};
+};
+
+// Values derived from the sequence of frames of one station. The state carries over from one capture to the next,
+// so the frames of a station have to be passed in order, every frame exactly once.
+class StationMetrics {
+ public:
+  explicit StationMetrics(const MetricsConfig &config);
+
+  // Applies the outlier filter to the frame and sets the derived values of the row
+  void update(FrameRow &row);
+
+ protected:
+  MetricsConfig config_;
+  std::unique_ptr<esphome::misol_weather::FrameFilter> filter_;
+  esphome::misol_weather::RainDetector rain_;
+  esphome::misol_weather::CrossingDetector gust_;
+  // Every frame is a transmission, including frames that failed the checks
+  uint64_t transmissions_{0};
+  esphome::misol_weather::IntensityWindow intensity_;
+};
+
+}  // namespace misol_decode
@@ -0,0 +1,110 @@
+// Cross-checks the vector kernels of the batch decoder against the scalar path, which is check_packet() and
+// decode_frame() of the component, on valid frames with random field bytes, damaged frames and random bytes.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "batch_decoder.h"
+
+using namespace misol_decode;
+
+namespace {
+
+void append_frame(std::vector<uint8_t> &data, std::mt19937 &random, bool with_pressure) {
+  size_t start = data.size();
+  data.push_back(0x24);
+  for (int i = 1; i < 16; i++)
+    data.push_back(random());
+  uint8_t checksum = 0;
+  for (int i = 0; i < 16; i++)
+    checksum += data[start + i];
+  data.push_back(checksum);
+  if (with_pressure) {
+    uint8_t trailer[3] = {(uint8_t) random(), (uint8_t) random(), (uint8_t) random()};
+    data.insert(data.end(), trailer, trailer + 3);
+    data.push_back(trailer[0] + trailer[1] + trailer[2]);
+  }
+}
+
+template<typename T> size_t count_differences(const char *name, BatchKernel kernel, const std::vector<T> &expected,
+                                              const std::vector<T> &actual) {
+  size_t differences = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i] != actual[i]) {
+      if (differences == 0) {
+        fprintf(stderr, "%s: %s of frame %zu is %lld, expected %lld\n", batch_kernel_to_string(kernel), name, i,
+                (long long) actual[i], (long long) expected[i]);
+      }
+      differences++;
+    }
+  }
+  return differences;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 random(20240601);
+  std::vector<uint8_t> data;
+  std::vector<uint64_t> offsets;
+  for (int i = 0; i < 20000; i++) {
+    uint32_t kind = random() % 8;
+    if (kind < 5) {
+      offsets.push_back(data.size());
+      append_frame(data, random, kind != 0);
+      // Damaged frames: single bit flips anywhere in the frame
+      if (kind == 4)
+        data[offsets.back() + random() % (data.size() - offsets.back())] ^= 1 << (random() % 8);
+    } else {
+      // Random bytes, half of them with a header
+      if (kind == 5)
+        data.push_back(0x24);
+      offsets.push_back(data.size());
+      for (int j = 0; j < 21; j++)
+        data.push_back(random());
+    }
+  }
+  // Positions inside frames, out of order
+  for (int i = 0; i < 5000; i++)
+    offsets.push_back(random() % (data.size() - 21));
+  // Frames at the end of the data without room for a pressure trailer
+  for (int i = 0; i < 4; i++)
+    offsets.push_back(data.size() - 17 - i);
+
+  FrameColumns expected;
+  decode_batch(data.data(), data.size(), offsets.data(), offsets.size(), expected, BatchKernel::SCALAR);
+  size_t valid = 0;
+  for (int8_t packet_type : expected.packet_type)
+    valid += packet_type >= 0;
+
+  size_t differences = 0;
+  for (BatchKernel kernel : {BatchKernel::SSE2, BatchKernel::AVX2, BatchKernel::NEON}) {
+    if (!is_batch_kernel_supported(kernel))
+      continue;
+    FrameColumns actual;
+    // Every frame count from the block size of the kernel and below, so the scalar remainder is covered too
+    for (size_t count : {offsets.size(), offsets.size() - 1, (size_t) 31, (size_t) 15}) {
+      decode_batch(data.data(), data.size(), offsets.data(), count, actual, kernel);
+      expected.resize(count);
+      decode_batch(data.data(), data.size(), offsets.data(), count, expected, BatchKernel::SCALAR);
+      differences += count_differences("packet_type", kernel, expected.packet_type, actual.packet_type);
+      differences += count_differences("wind_direction", kernel, expected.wind_direction, actual.wind_direction);
+      differences += count_differences("low_battery", kernel, expected.low_battery, actual.low_battery);
+      differences += count_differences("temperature", kernel, expected.temperature, actual.temperature);
+      differences += count_differences("humidity", kernel, expected.humidity, actual.humidity);
+      differences += count_differences("wind_speed", kernel, expected.wind_speed, actual.wind_speed);
+      differences += count_differences("wind_gust", kernel, expected.wind_gust, actual.wind_gust);
+      differences += count_differences("precipitation", kernel, expected.precipitation, actual.precipitation);
+      differences += count_differences("uv_intensity", kernel, expected.uv_intensity, actual.uv_intensity);
+      differences += count_differences("light", kernel, expected.light, actual.light);
+      differences += count_differences("pressure", kernel, expected.pressure, actual.pressure);
+    }
+    printf("%s: checked %zu frames, %zu valid\n", batch_kernel_to_string(kernel), offsets.size(), valid);
+  }
+  if (differences != 0) {
+    fprintf(stderr, "%zu differences\n", differences);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,240 @@
+// Writes rows with nulls, dictionary values and every column type over several row groups with the ColumnEncoder
+// of the component, reads the file back with an independent reader of the format and compares.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "column_encoder.h"
+
+using namespace esphome::misol_weather;
+
+namespace {
+
+class MemorySink : public ColumnSink {
+ public:
+  void write(const uint8_t *data, size_t length) override { this->data.insert(this->data.end(), data, data + length); }
+  std::vector<uint8_t> data;
+};
+
+// Value of a cell, has_value is false for null
+struct Cell {
+  bool has_value;
+  uint64_t value;
+};
+
+struct ReadColumn {
+  std::string name;
+  uint8_t type;
+  bool nullable;
+  double scale;
+  double offset;
+  std::vector<std::string> labels;
+  std::vector<Cell> cells;
+};
+
+class Reader {
+ public:
+  explicit Reader(const std::vector<uint8_t> &data) : data_(data) {}
+
+  // Returns false on a malformed file
+  bool read(std::vector<ReadColumn> &columns, size_t &groups) {
+    if ((this->data_.size() < 6) || (memcmp(this->data_.data(), "MWCF", 4) != 0) || (this->data_[4] != 1))
+      return false;
+    this->position_ = 5;
+    columns.resize(this->uint_(1));
+    for (ReadColumn &column : columns) {
+      column.name = this->string_();
+      column.type = this->uint_(1);
+      column.nullable = this->uint_(1) != 0;
+      column.scale = this->double_();
+      column.offset = this->double_();
+      if (column.type == (uint8_t) ColumnType::DICTIONARY) {
+        column.labels.resize(this->uint_(1));
+        for (std::string &label : column.labels)
+          label = this->string_();
+      }
+    }
+    groups = 0;
+    while (true) {
+      size_t rows = this->uint_(4);
+      if (this->overflow_)
+        return false;
+      if (rows == 0)
+        return this->position_ == this->data_.size();
+      groups++;
+      for (ReadColumn &column : columns) {
+        size_t validity = this->position_;
+        if (column.nullable)
+          this->position_ += (rows + 7) / 8;
+        for (size_t row = 0; row < rows; row++) {
+          bool valid = !column.nullable || ((this->byte_(validity + row / 8) >> (row % 8)) & 1);
+          uint64_t value = this->uint_(size_of_(column.type));
+          // Nulls are stored as 0
+          if (!valid && (value != 0))
+            return false;
+          column.cells.push_back({valid, value});
+        }
+      }
+    }
+  }
+
+ protected:
+  static uint8_t size_of_(uint8_t type) {
+    switch ((ColumnType) type) {
+      case ColumnType::UINT16:
+        return 2;
+      case ColumnType::UINT32:
+      case ColumnType::INT32:
+        return 4;
+      case ColumnType::UINT64:
+        return 8;
+      default:
+        return 1;
+    }
+  }
+  uint8_t byte_(size_t position) {
+    if (position >= this->data_.size()) {
+      this->overflow_ = true;
+      return 0;
+    }
+    return this->data_[position];
+  }
+  uint64_t uint_(uint8_t size) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < size; i++)
+      value |= (uint64_t) this->byte_(this->position_++) << (8 * i);
+    return value;
+  }
+  double double_() {
+    uint64_t bits = this->uint_(8);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  std::string string_() {
+    size_t length = this->uint_(1);
+    std::string value;
+    for (size_t i = 0; i < length; i++)
+      value.push_back(this->byte_(this->position_++));
+    return value;
+  }
+
+  const std::vector<uint8_t> &data_;
+  size_t position_{0};
+  bool overflow_{false};
+};
+
+const char *const LABELS[] = {"calm", "breezy", "storm"};
+
+struct Definition {
+  const char *name;
+  ColumnType type;
+  bool nullable;
+  uint64_t mask;
+};
+
+const Definition DEFINITIONS[] = {
+    {"u8", ColumnType::UINT8, false, 0xFF},
+    {"u16", ColumnType::UINT16, true, 0xFFFF},
+    {"u32", ColumnType::UINT32, true, 0xFFFFFFFF},
+    {"u64", ColumnType::UINT64, true, UINT64_MAX},
+    {"i32", ColumnType::INT32, true, 0xFFFFFFFF},
+    {"dictionary", ColumnType::DICTIONARY, true, 0},
+};
+
+size_t check_rows(size_t rows, uint16_t rows_per_group, std::mt19937 &random) {
+  MemorySink sink;
+  ColumnEncoder encoder(&sink, rows_per_group);
+  size_t count = sizeof(DEFINITIONS) / sizeof(DEFINITIONS[0]);
+  for (size_t i = 0; i < count; i++) {
+    const Definition &definition = DEFINITIONS[i];
+    if (definition.type == ColumnType::DICTIONARY) {
+      encoder.add_dictionary_column(definition.name, LABELS, 3, definition.nullable);
+    } else {
+      encoder.add_column(definition.name, definition.type, definition.nullable, 0.1 * (i + 1), -40.0);
+    }
+  }
+  std::vector<std::vector<Cell>> expected(count);
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t i = 0; i < count; i++) {
+      const Definition &definition = DEFINITIONS[i];
+      uint64_t value = (((uint64_t) random() << 32) | random()) & definition.mask;
+      if (definition.type == ColumnType::DICTIONARY)
+        value = random() % 3;
+      Cell cell{!definition.nullable || (random() % 4 != 0), value};
+      if (cell.has_value) {
+        encoder.set(i, value);
+      } else {
+        cell.value = 0;
+      }
+      expected[i].push_back(cell);
+    }
+    encoder.end_row();
+  }
+  encoder.finish();
+
+  std::vector<ReadColumn> columns;
+  size_t groups;
+  if (!Reader(sink.data).read(columns, groups)) {
+    fprintf(stderr, "%zu rows in groups of %u: malformed file\n", rows, rows_per_group);
+    return 1;
+  }
+  size_t differences = 0;
+  size_t expected_groups = (rows + rows_per_group - 1) / rows_per_group;
+  if ((columns.size() != count) || (groups != expected_groups)) {
+    fprintf(stderr, "%zu rows in groups of %u: %zu columns and %zu groups\n", rows, rows_per_group, columns.size(),
+            groups);
+    return 1;
+  }
+  for (size_t i = 0; i < count; i++) {
+    const Definition &definition = DEFINITIONS[i];
+    const ReadColumn &column = columns[i];
+    bool dictionary = definition.type == ColumnType::DICTIONARY;
+    if ((column.name != definition.name) || (column.type != (uint8_t) definition.type) ||
+        (column.nullable != definition.nullable) || (!dictionary && (column.scale != 0.1 * (i + 1))) ||
+        (!dictionary && (column.offset != -40.0)) || (column.labels.size() != (dictionary ? 3 : 0))) {
+      fprintf(stderr, "column %s: schema differs\n", definition.name);
+      differences++;
+    }
+    for (size_t label = 0; label < column.labels.size(); label++) {
+      if (column.labels[label] != LABELS[label]) {
+        fprintf(stderr, "column %s: label %zu is %s\n", definition.name, label, column.labels[label].c_str());
+        differences++;
+      }
+    }
+    for (size_t row = 0; row < rows; row++) {
+      const Cell &actual = column.cells[row];
+      const Cell &wanted = expected[i][row];
+      if ((actual.has_value != wanted.has_value) || (actual.value != wanted.value)) {
+        if (differences == 0) {
+          fprintf(stderr, "column %s row %zu: %d %llu, expected %d %llu\n", definition.name, row, actual.has_value,
+                  (unsigned long long) actual.value, wanted.has_value, (unsigned long long) wanted.value);
+        }
+        differences++;
+      }
+    }
+  }
+  printf("%zu rows in groups of %u: %zu groups, %zu bytes\n", rows, rows_per_group, groups, sink.data.size());
+  return differences;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 random(20240701);
+  size_t differences = 0;
+  // Empty file, partial last group, exact multiple of the group size and group sizes not divisible by 8
+  differences += check_rows(0, 16, random);
+  differences += check_rows(5, 16, random);
+  differences += check_rows(64, 16, random);
+  differences += check_rows(1000, 13, random);
+  differences += check_rows(70000, 65535, random);
+  if (differences != 0) {
+    fprintf(stderr, "%zu differences\n", differences);
+    return 1;
+  }
+  return 0;
+}
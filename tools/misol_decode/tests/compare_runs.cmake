@@ -0,0 +1,26 @@
+# Decodes the test captures sequentially and with many small shards on several threads, the outputs have to be
+# identical. Expects DECODER, CAPTURES, OUTPUT and FORMAT.
+set(CAPTURE_FILES ${CAPTURES}/station_a/0001.bin ${CAPTURES}/station_b/0001.bin ${CAPTURES}/station_a/0002.bin)
+set(OPTIONS -f ${FORMAT} --all --filter hampel)
+
+execute_process(
+  COMMAND ${DECODER} ${OPTIONS} -j 1 -o ${OUTPUT}.sequential ${CAPTURE_FILES}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Sequential run failed")
+endif()
+
+foreach(SHARD_SIZE 997 4096 65536)
+  execute_process(
+    COMMAND ${DECODER} ${OPTIONS} -j 4 --shard-size ${SHARD_SIZE} -o ${OUTPUT}.parallel ${CAPTURE_FILES}
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Parallel run with ${SHARD_SIZE} byte shards failed")
+  endif()
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT}.sequential ${OUTPUT}.parallel
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Output with ${SHARD_SIZE} byte shards differs from the sequential run")
+  endif()
+endforeach()
@@ -0,0 +1,147 @@
+// Scans generated transmissions through the frame scanner of the component: without noise every frame has to be
+// found with exactly the generated values, with a month of link damage hardly any undamaged frame may be lost and
+// hardly any frame with values that were never sent accepted. The weather has to contain the promised events.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "frame_generator.h"
+#include "frame_scanner.h"
+
+using namespace esphome::misol_weather;
+using namespace misol_decode;
+
+namespace {
+
+// A frame whose pressure trailer was damaged is accepted without pressure, the other fields still have to match
+bool same_values(const DecodedFrame &accepted, const DecodedFrame &sent) {
+  uint16_t changed = accepted.get_changed_fields(sent);
+  uint64_t quality_mask = UINT64_MAX;
+  if (!accepted.has_pressure) {
+    changed &= ~(1 << FIELD_PRESSURE);
+    quality_mask &= ~(((uint64_t) (1 << QUALITY_BITS_PER_FIELD) - 1) << (FIELD_PRESSURE * QUALITY_BITS_PER_FIELD));
+  }
+  return (changed == 0) && (accepted.security_code == sent.security_code) &&
+         ((accepted.quality & quality_mask) == (sent.quality & quality_mask));
+}
+
+struct ScanResult {
+  std::vector<bool> found;
+  size_t accepted{0};
+  size_t unmatched{0};
+};
+
+// Accepted frames are matched to the transmissions in order, damaged transmissions may be missing
+void scan(const std::vector<Transmission> &transmissions, ScanResult &result) {
+  std::vector<uint8_t> capture;
+  for (const Transmission &transmission : transmissions)
+    capture.insert(capture.end(), transmission.bytes.begin(), transmission.bytes.end());
+  result.found.assign(transmissions.size(), false);
+  size_t next = 0;
+  scan_frames(
+      capture.data(), capture.size(), true,
+      [&](size_t offset, size_t length, FrameResult frame_result) {
+        if ((frame_result != FrameResult::BASIC_PACKET) && (frame_result != FrameResult::BASIC_WITH_PRESSURE))
+          return;
+        result.accepted++;
+        DecodedFrame frame;
+        decode_frame(capture.data() + offset, length, frame_result == FrameResult::BASIC_WITH_PRESSURE, frame);
+        for (size_t i = next; i < transmissions.size(); i++) {
+          if (same_values(frame, transmissions[i].frame)) {
+            result.found[i] = true;
+            next = i + 1;
+            return;
+          }
+        }
+        result.unmatched++;
+      },
+      [](size_t, bool) {});
+}
+
+std::vector<Transmission> generate(const WeatherConfig &weather, const NoiseConfig &noise, size_t count) {
+  FrameGenerator generator(weather, noise);
+  std::vector<Transmission> transmissions(count);
+  for (Transmission &transmission : transmissions)
+    generator.next(transmission);
+  return transmissions;
+}
+
+}  // namespace
+
+int main() {
+  WeatherConfig weather;
+  weather.seed = 20240801;
+  size_t failures = 0;
+
+  // Without noise every frame is found as sent
+  std::vector<Transmission> transmissions = generate(weather, NoiseConfig{}, 5400);
+  ScanResult clean;
+  scan(transmissions, clean);
+  if ((clean.accepted != transmissions.size()) || (clean.unmatched != 0)) {
+    fprintf(stderr, "without noise %zu of %zu frames accepted, %zu never sent\n", clean.accepted,
+            transmissions.size(), clean.unmatched);
+    failures++;
+  }
+
+  const size_t count = 30 * 5400;
+  transmissions = generate(weather, NoiseConfig{0.01f, 0.01f, 0.01f, 0.01f, 0.01f}, count);
+  ScanResult noisy;
+  scan(transmissions, noisy);
+  // The 8 bit checksums accept about one in 256 random byte runs starting with a header
+  if (noisy.unmatched > count / 10000) {
+    fprintf(stderr, "%zu accepted frames were never sent\n", noisy.unmatched);
+    failures++;
+  }
+
+  size_t damaged = 0;
+  size_t lost = 0;
+  bool wrapped = false;
+  bool gale = false;
+  bool low_battery = false;
+  bool sentinel = false;
+  float warmest_hour_sum = 0.0f;
+  size_t days = 0;
+  float warmest = -100.0f;
+  size_t warmest_index = 0;
+  for (size_t i = 0; i < count; i++) {
+    const Transmission &transmission = transmissions[i];
+    const DecodedFrame &frame = transmission.frame;
+    if (transmission.noise & NOISE_DAMAGED) {
+      damaged++;
+    } else if (!noisy.found[i]) {
+      lost++;
+    }
+    if ((i > 0) && (transmission.time_ms < transmissions[i - 1].time_ms)) {
+      fprintf(stderr, "transmission %zu sent before the previous one\n", i);
+      failures++;
+    }
+    if ((i > 0) && (frame.precipitation < transmissions[i - 1].frame.precipitation))
+      wrapped = true;
+    gale |= frame.get_wind_gust() > 17.2f;
+    low_battery |= frame.low_battery;
+    sentinel |= (frame.get_degraded_fields() != 0);
+    if (frame.get_temperature() > warmest) {
+      warmest = frame.get_temperature();
+      warmest_index = i;
+    }
+    if ((i + 1) % 5400 == 0) {
+      warmest_hour_sum += (warmest_index % 5400) * 16.0f / 3600.0f;
+      days++;
+      warmest = -100.0f;
+    }
+  }
+  // Garbage before a frame can pass the basic checksum by chance and take the header of the frame with it
+  if (lost > count / 4000) {
+    fprintf(stderr, "%zu undamaged frames not found\n", lost);
+    failures++;
+  }
+  float warmest_hour = warmest_hour_sum / days;
+  if (!wrapped || !gale || !low_battery || !sentinel || (warmest_hour < 12.0f) || (warmest_hour > 18.0f)) {
+    fprintf(stderr, "missing weather: wrapped %d, gale %d, low battery %d, sentinel %d, warmest at %.1f h\n", wrapped,
+            gale, low_battery, sentinel, warmest_hour);
+    failures++;
+  }
+  printf("%zu transmissions, %zu damaged, %zu accepted, %zu undamaged lost, warmest at %.1f h\n", count, damaged,
+         noisy.accepted, lost, warmest_hour);
+  return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+// Serializes a known frame with the writers of the component: the line protocol message has to arrive unchanged
+// as one datagram on a loopback socket through the UdpSender, the Prometheus exposition has to match exactly.
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "frame_generator.h"
+#include "frame_scanner.h"
+#include "frame_serializer.h"
+#include "udp_sender.h"
+
+using namespace esphome::misol_weather;
+using namespace misol_decode;
+
+namespace {
+
+// Light rain on a mild afternoon, the UV sensor reports not available
+DecodedFrame make_frame() {
+  DecodedFrame sent;
+  sent.security_code = 0x5A;
+  sent.wind_direction = 225;
+  sent.temperature = 400 + 187;
+  sent.humidity = 71;
+  sent.wind_speed = 25;
+  sent.wind_gust = 4;
+  sent.precipitation = 1234;
+  sent.uv_intensity = UV_INTENSITY_NOT_AVAILABLE;
+  sent.light = 123456;
+  sent.low_battery = true;
+  sent.has_pressure = true;
+  sent.pressure = 101325;
+  uint8_t buffer[PRESSURE_PACKET_SIZE];
+  DecodedFrame frame;
+  decode_frame(buffer, encode_frame(sent, buffer), true, frame);
+  frame.epoch_ms = 1722513600123;
+  return frame;
+}
+
+const char *const LINE_PROTOCOL =
+    "weather,station=garden temperature=18.7,humidity=71,pressure=1013.25,wind_speed=3.50,wind_gust=4.48,"
+    "wind_direction=225,accumulated_precipitation=370.2,precipitation_intensity=1.2,light=12345.6,"
+    "low_battery=true,quality=268435456i 1722513600123000000\n";
+
+size_t check_udp(const DecodedFrame &frame) {
+  uint8_t message[MAX_FRAME_MESSAGE_SIZE];
+  size_t length = serialize_frame(FrameFormat::LINE_PROTOCOL, frame, 1.2f, message, sizeof(message),
+                                  "weather,station=garden");
+  if (std::string(reinterpret_cast<char *>(message), length) != LINE_PROTOCOL) {
+    fprintf(stderr, "line protocol:\n%.*s", (int) length, message);
+    return 1;
+  }
+
+  int receiver = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  struct sockaddr_in address {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  struct timeval timeout {2, 0};
+  if ((receiver < 0) || (bind(receiver, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) ||
+      (getsockname(receiver, reinterpret_cast<struct sockaddr *>(&address), &address_length) != 0) ||
+      (setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0)) {
+    perror("loopback socket");
+    return 1;
+  }
+
+  size_t failures = 0;
+  UdpSender sender;
+  if (sender.set_address("127.0.0.256", 8089) || sender.send(message, length)) {
+    fprintf(stderr, "an invalid address was accepted\n");
+    failures++;
+  }
+  // The socket is opened by the first send, the second one reuses it
+  if (!sender.set_address("127.0.0.1", ntohs(address.sin_port)) || !sender.send(message, length) ||
+      !sender.send(message, length)) {
+    fprintf(stderr, "sending to the loopback socket failed\n");
+    failures++;
+  }
+  for (int i = 0; i < 2; i++) {
+    char datagram[2 * MAX_FRAME_MESSAGE_SIZE];
+    ssize_t received = recv(receiver, datagram, sizeof(datagram), 0);
+    if ((received < 0) || (std::string(datagram, received) != LINE_PROTOCOL)) {
+      fprintf(stderr, "datagram %d: %.*s\n", i, (int) std::max<ssize_t>(received, 0), datagram);
+      failures++;
+    }
+  }
+  close(receiver);
+  return failures;
+}
+
+const char *const PROMETHEUS = "# TYPE misol_time_seconds gauge\n"
+                               "misol_time_seconds 1722513600.123\n"
+                               "# TYPE misol_temperature gauge\n"
+                               "misol_temperature 18.7\n"
+                               "# TYPE misol_humidity gauge\n"
+                               "misol_humidity 71\n"
+                               "# TYPE misol_pressure gauge\n"
+                               "misol_pressure 1013.25\n"
+                               "# TYPE misol_wind_speed gauge\n"
+                               "misol_wind_speed 3.50\n"
+                               "# TYPE misol_wind_gust gauge\n"
+                               "misol_wind_gust 4.48\n"
+                               "# TYPE misol_wind_direction gauge\n"
+                               "misol_wind_direction 225\n"
+                               "# TYPE misol_accumulated_precipitation gauge\n"
+                               "misol_accumulated_precipitation 370.2\n"
+                               "# TYPE misol_precipitation_intensity gauge\n"
+                               "misol_precipitation_intensity 1.2\n"
+                               "# TYPE misol_light gauge\n"
+                               "misol_light 12345.6\n"
+                               "# TYPE misol_low_battery gauge\n"
+                               "misol_low_battery 1\n"
+                               "# TYPE misol_quality gauge\n"
+                               "misol_quality 268435456\n";
+
+size_t check_prometheus(const DecodedFrame &frame) {
+  uint8_t text[MAX_FRAME_METRICS_SIZE];
+  size_t length = serialize_frame(FrameFormat::PROMETHEUS, frame, 1.2f, text, sizeof(text), "misol_");
+  if (std::string(reinterpret_cast<char *>(text), length) != PROMETHEUS) {
+    fprintf(stderr, "prometheus:\n%.*s", (int) length, text);
+    return 1;
+  }
+  // A buffer that is too small gives no partial output
+  if (serialize_frame(FrameFormat::PROMETHEUS, frame, 1.2f, text, length - 1, "misol_") != 0) {
+    fprintf(stderr, "prometheus output was truncated\n");
+    return 1;
+  }
+  return 0;
+}
+
+// The config validation allows line protocol prefixes of up to 231 bytes (LINE_PROTOCOL_MAX_FIELDS_SIZE in
+// __init__.py), the longest field set has to fit with such a prefix but not with a longer one
+size_t check_longest_line_protocol() {
+  static const size_t MAX_PREFIX_LENGTH = 231;
+  DecodedFrame frame;
+  frame.temperature = 0;
+  frame.humidity = HUMIDITY_NOT_AVAILABLE - 1;
+  frame.has_pressure = true;
+  frame.pressure = 0xFFFFFF;
+  frame.wind_speed = WIND_SPEED_NOT_AVAILABLE - 1;
+  frame.wind_gust = WIND_GUST_NOT_AVAILABLE - 1;
+  frame.wind_direction = WIND_DIRECTION_NOT_AVAILABLE - 1;
+  frame.precipitation = 0xFFFF;
+  frame.uv_intensity = UV_INTENSITY_NOT_AVAILABLE - 1;
+  frame.light = LIGHT_NOT_AVAILABLE - 1;
+  frame.quality = (1ULL << (FIELD_COUNT * QUALITY_BITS_PER_FIELD)) - 1;
+  frame.epoch_ms = 9999999999999;
+  uint8_t message[MAX_FRAME_MESSAGE_SIZE];
+  std::string prefix(MAX_PREFIX_LENGTH, 'w');
+  if (serialize_frame(FrameFormat::LINE_PROTOCOL, frame, -99999.9f, message, sizeof(message), prefix.c_str()) == 0) {
+    fprintf(stderr, "longest line protocol message does not fit with a %u byte prefix\n", (unsigned) prefix.size());
+    return 1;
+  }
+  prefix += 'w';
+  if (serialize_frame(FrameFormat::LINE_PROTOCOL, frame, -99999.9f, message, sizeof(message), prefix.c_str()) != 0) {
+    fprintf(stderr, "line protocol prefixes longer than %u bytes fit\n", (unsigned) MAX_PREFIX_LENGTH);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  DecodedFrame frame = make_frame();
+  size_t failures = check_udp(frame) + check_prometheus(frame) + check_longest_line_protocol();
+  return (failures != 0) ? 1 : 0;
+}
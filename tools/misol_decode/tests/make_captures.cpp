@@ -0,0 +1,95 @@
+// Writes synthetic captures of two stations with the usual damage of a real link: corrupted frames, corrupted
+// pressure trailers, noise between frames and a truncated last frame.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+uint32_t random_state = 1;
+
+uint32_t next_random() {
+  random_state = random_state * 1103515245 + 12345;
+  return random_state >> 8;
+}
+
+void append_frame(std::vector<uint8_t> &capture, uint32_t index) {
+  uint8_t frame[21] = {0x24, 0x5A};
+  uint16_t wind_direction = next_random() % 360;
+  uint16_t temperature = 200 + next_random() % 500;
+  uint16_t wind_speed = next_random() % 300;
+  uint16_t precipitation = (index / 12) % 200 + (index / 3000) * 40;
+  uint16_t uv_intensity = next_random() % 2000;
+  uint32_t light = next_random() % 1000000;
+  uint32_t pressure = 95000 + next_random() % 10000;
+  frame[2] = wind_direction;
+  frame[3] = ((wind_direction >> 8) << 7) | ((wind_speed >> 8) << 4) | (temperature >> 8);
+  frame[4] = temperature;
+  frame[5] = 10 + next_random() % 90;
+  frame[6] = wind_speed;
+  // Gusts cross the gale band now and then
+  frame[7] = ((index / 40) % 3 == 0) ? 16 + next_random() % 4 : next_random() % 12;
+  frame[8] = precipitation >> 8;
+  frame[9] = precipitation;
+  frame[10] = uv_intensity >> 8;
+  frame[11] = uv_intensity;
+  frame[12] = light >> 16;
+  frame[13] = light >> 8;
+  frame[14] = light;
+  for (int i = 0; i < 16; i++)
+    frame[16] += frame[i];
+  frame[17] = pressure >> 16;
+  frame[18] = pressure >> 8;
+  frame[19] = pressure;
+  frame[20] = frame[17] + frame[18] + frame[19];
+  uint32_t damage = next_random() % 100;
+  if (damage == 0)
+    frame[16] ^= 0x01;
+  if (damage == 1)
+    frame[20] ^= 0x10;
+  if (damage == 2)
+    frame[5 + next_random() % 10] = 0x24;
+  if (damage == 3) {
+    // Noise with header bytes between frames
+    for (uint32_t count = next_random() % 30; count > 0; count--)
+      capture.push_back((next_random() % 4 == 0) ? 0x24 : next_random());
+  }
+  capture.insert(capture.end(), frame, frame + sizeof(frame));
+}
+
+bool write_capture(const std::string &path, uint32_t first_index, uint32_t frames, bool truncated) {
+  std::vector<uint8_t> capture;
+  for (uint32_t i = 0; i < frames; i++)
+    append_frame(capture, first_index + i);
+  if (truncated)
+    capture.resize(capture.size() - 9);
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  bool written = fwrite(capture.data(), 1, capture.size(), file) == capture.size();
+  return (fclose(file) == 0) && written;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: make_captures directory\n");
+    return 2;
+  }
+  std::string directory = argv[1];
+  mkdir(directory.c_str(), 0755);
+  mkdir((directory + "/station_a").c_str(), 0755);
+  mkdir((directory + "/station_b").c_str(), 0755);
+  bool ok = write_capture(directory + "/station_a/0001.bin", 0, 20000, true) &&
+            write_capture(directory + "/station_a/0002.bin", 20000, 15000, false) &&
+            write_capture(directory + "/station_b/0001.bin", 0, 30000, false);
+  if (!ok) {
+    fprintf(stderr, "make_captures: writing to %s failed\n", directory.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,65 @@
+"""Decodes the test captures as CSV and as a column file, reads the column file with mwcf.py and compares every
+column both outputs have. Expects the decoder, the capture directory and an output prefix as arguments."""
+
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import mwcf  # noqa: E402
+
+CAPTURE_FILES = ["station_a/0001.bin", "station_b/0001.bin", "station_a/0002.bin"]
+OPTIONS = ["--all", "--filter", "hampel"]
+
+
+def decode(decoder, captures, format_, output):
+    files = [os.path.join(captures, name) for name in CAPTURE_FILES]
+    subprocess.run([decoder, "-f", format_] + OPTIONS + ["-o", output] + files, check=True)
+
+
+def main(decoder, captures, output):
+    decode(decoder, captures, "csv", output + ".csv")
+    decode(decoder, captures, "columns", output + ".mwc")
+    table = mwcf.read(output + ".mwc")
+    with open(output + ".csv") as file:
+        lines = file.read().splitlines()
+    names = lines[0].split(",")
+    rows = [line.split(",") for line in lines[1:]]
+    if table.rows != len(rows) or table.rows == 0:
+        print("%d rows in the column file, %d in the CSV file" % (table.rows, len(rows)))
+        return 1
+
+    differences = 0
+    compared = []
+    for index, name in enumerate(names):
+        try:
+            column = table[name]
+        except KeyError:
+            continue
+        compared.append(name)
+        for row, (value, expected) in enumerate(zip(column.values(), (fields[index] for fields in rows))):
+            if expected == "" or value is None:
+                same = (expected == "") and (value is None)
+            elif isinstance(value, str):
+                same = value == expected
+            else:
+                # Half of the last digit written to the CSV file
+                decimals = len(expected.partition(".")[2])
+                same = abs(value - float(expected)) <= 0.5 * 10**-decimals + 1e-9
+            if not same:
+                if differences == 0:
+                    print("%s row %d: %r, expected %r" % (name, row, value, expected))
+                differences += 1
+    missing = set(table.names) - set(compared) - {"compass_direction"}
+    if missing:
+        print("columns not in the CSV file: %s" % ", ".join(sorted(missing)))
+        return 1
+    print("%d rows in %d row groups, %d columns compared" % (table.rows, table.row_groups, len(compared)))
+    if differences:
+        print("%d differences" % differences)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(*sys.argv[1:]))